@@ -3,3 +3,8 @@
  */
 #include "allocator.hpp"
 
+#include <type_traits>
+
+/* containers copy and rebind their allocators all the time */
+static_assert(std::is_trivially_copyable<StaticMemoryAllocator::allocator<char>>::value,
+              "the allocator has to be a trivially copyable pointer to its arena");
@@ -6,7 +6,8 @@
  * \author Angelos Drossos <angelos.drossos@gmail.com>
  */
 
-#include <boost/dynamic_bitset.hpp>
+#include "arena.hpp"
+#include "trace.hpp"
 
 #include <memory>
 #include <cstdint>
@@ -14,54 +15,86 @@
 #include <exception>    // std::exception
 #include <new>          // std::bad_alloc
 #include <string>
+#include <type_traits>
 
 #include <assert.h>
 
 namespace StaticMemoryAllocator {
 
-template <class T>
+/**
+ * Allocator of a static memory block, managed by an arena
+ * (which is shared by all copies of the allocator).
+ *
+ * The allocator is just a pointer to the arena, thus copying,
+ * rebinding and comparing allocators costs nothing. The arena is
+ * not owned by the allocator, it has to outlive all allocators
+ * (and all containers) using it.
+ *
+ * The pointer type is arena_pointer<Arena, T>::type, i.e. T *
+ * for all arenas but mapped_arena.
+ *
+ * \tparam T Value type.
+ * \tparam Arena Type of the arena, e.g. a bitmap_arena of a given granule size.
+ * \tparam Trace Tracing policy: null_trace (nothing is traced, no code is
+ * 	      generated for it) or ring_trace (allocations, deallocations,
+ * 	      expansions and shrinks are recorded into a trace_ring).
+ */
+template <class T, class Arena = bitmap_arena<>, class Trace = null_trace>
 class allocator
 {
-private:
-	typedef uint8_t                            block_type;
-	typedef uint8_t                            byte;
-	typedef boost::dynamic_bitset<block_type>  dynamic_bitset;
-
 public:
+	typedef Arena              arena_type;
+	typedef Trace              trace_type;
 	typedef T                  value_type;
-	typedef value_type       * pointer;
-	typedef value_type       & reference;
-	typedef const value_type * const_pointer;
-	typedef const value_type & const_reference;
+	typedef typename arena_pointer<Arena, value_type>::type       pointer;
+	typedef value_type                                            & reference;
+	typedef typename arena_pointer<Arena, const value_type>::type const_pointer;
+	typedef const value_type                                      & const_reference;
 	typedef std::size_t        size_type;
 	typedef std::ptrdiff_t     difference_type;
 
 	template <class _T1>
 	struct rebind
 	{
-		typedef allocator<_T1> other;
+		typedef allocator<_T1, Arena, Trace> other;
 	};
 
+	/*
+	 * a container moves and swaps its allocator with its memory block,
+	 * thus a move or swap of two containers (of any arenas) only swaps pointers.
+	 * A copy keeps the arena of the target container.
+	 */
+	typedef std::false_type    propagate_on_container_copy_assignment;
+	typedef std::true_type     propagate_on_container_move_assignment;
+	typedef std::true_type     propagate_on_container_swap;
+	/* allocators of different arenas are not equal */
+	typedef std::false_type    is_always_equal;
+
 /* constructors, destructors, assignment operators */
 public:
 
 	allocator() = delete;
 	
-	allocator(void *const memstart, const size_type memsize, const std::string & memname = "") throw();
+	/**
+	 * Uses the arena \p a, which has to outlive the allocator (and all its copies).
+	 */
+	explicit allocator(arena_type & a) throw();
 	
-	allocator(const allocator & a);
+	allocator(const allocator & a) = default;
 	
-	allocator(allocator && a);
+	allocator(allocator && a) = default;
 	
 	template <class T2>
-	allocator(const allocator<T2> & a) throw();
+	allocator(const allocator<T2, Arena, Trace> & a) throw();
 	
-	~allocator() throw();
+	~allocator() = default;
 	
-	allocator & operator =(const allocator & a);
+	allocator & operator =(const allocator & a) = default;
+
+	allocator & operator =(allocator && a) = default;
 
 	template <class T2>
-	allocator & operator =(const allocator<T2> & a);
+	allocator & operator =(const allocator<T2, Arena, Trace> & a);
 
 /* important allocator functions */
 public:
@@ -70,9 +103,54 @@ public:
 	
 	const_pointer address(const_reference r) const; // optional
 	
+	/**
+	 * Allocates memory for \p n elements, aligned to alignof(T).
+	 *
+	 * \throw std::bad_alloc If there is no large enough free memory block.
+	 */
 	pointer allocate(size_type n, void *const hint = nullptr);
+
+	/**
+	 * Allocates memory for \p n elements, aligned to \p alignment
+	 * (a power of two, e.g. cache_line_size), but at least to alignof(T).
+	 *
+	 * \throw std::bad_alloc If there is no large enough free memory block.
+	 */
+	pointer allocate_aligned(size_type n, size_type alignment, void *const hint = nullptr);
 	
 	void deallocate(pointer p, size_type n);
+
+	/**
+	 * Allocates \p count memory blocks of \p n elements each, aligned to alignof(T),
+	 * and stores their pointers to \p out (e.g. for nodes created in bulk).
+	 * The blocks are claimed together, if the arena supports it
+	 * (like the bitmap_arena), otherwise one by one.
+	 * Either all or none of the blocks are allocated.
+	 *
+	 * \throw std::bad_alloc If there is not enough free memory.
+	 */
+	void allocate_batch(size_type count, size_type n, pointer *out);
+
+	/**
+	 * Deallocates the \p count memory blocks of \p n elements at \p ps.
+	 */
+	void deallocate_batch(const pointer *ps, size_type count, size_type n);
+
+	/**
+	 * Grows the memory block of \p old_n elements at \p p to \p new_n elements
+	 * without moving it, i.e. only if the memory behind the block is free.
+	 *
+	 * \return false (and the block is unchanged), if the block cannot grow in place.
+	 */
+	bool expand_in_place(pointer p, size_type old_n, size_type new_n);
+
+	/**
+	 * Shrinks the memory block of \p old_n elements at \p p to \p new_n elements
+	 * (\p new_n > 0) without moving it, the rest of the block is freed.
+	 *
+	 * \return false (and the block is unchanged), if the arena cannot shrink the block.
+	 */
+	bool shrink_in_place(pointer p, size_type old_n, size_type new_n);
 	
 	size_type max_size();
 
@@ -106,7 +184,15 @@ public:
 	template <class U>
 	void destroy(U *p); // optional
 
-	bool operator !=(const allocator & a) const;
+	/**
+	 * Returns true, if both allocators use the same arena
+	 * (i.e., memory of one can be freed by the other).
+	 */
+	template <class T2>
+	bool operator ==(const allocator<T2, Arena, Trace> & a) const;
+
+	template <class T2>
+	bool operator !=(const allocator<T2, Arena, Trace> & a) const;
 
 public:
 
@@ -116,34 +202,38 @@ public:
 
 private:
 
-	static
-	dynamic_bitset create_mask(const size_type nb, const size_type memsize);
+	/* number of blocks passed to the arena at once */
+	static const size_type batch_size = 256;
 
+	template <class A>
 	static
-	size_type find_free_memory(const dynamic_bitset & memfree, dynamic_bitset & mask);
+	auto arena_allocate_batch(A & a, size_type count, size_type nb, size_type alignment, void **out, int)
+		-> decltype(a.allocate_batch(count, nb, alignment, out));
 
+	/* for arenas without allocate_batch() */
+	template <class A>
 	static
-	pointer calc_pointer(void *const memstart, const size_type mempos);
+	bool arena_allocate_batch(A & a, size_type count, size_type nb, size_type alignment, void **out, long);
 
+	template <class A>
 	static
-	size_type calc_pos(void *const memstart, void *const pmem);
+	auto arena_deallocate_batch(A & a, void *const *ps, size_type count, size_type nb, int)
+		-> decltype(a.deallocate_batch(ps, count, nb));
 
+	/* for arenas without deallocate_batch() */
+	template <class A>
 	static
-	dynamic_bitset reserve_memory(const dynamic_bitset & memfree,
-		                      dynamic_bitset && mask);
+	void arena_deallocate_batch(A & a, void *const *ps, size_type count, size_type nb, long);
 
-	static
-	dynamic_bitset free_memory(const dynamic_bitset & memfree,
-			           dynamic_bitset && mask);
+	/* records an event of the memory block at p (or nullptr) */
+	void trace(const trace_op op, const void *const p, const size_type nb) const;
 
 /* member variables */
 private:
 
-	void *memstart;
-	std::shared_ptr<dynamic_bitset> memfree;
-	std::string memname;
+	typename arena_pointer<Arena, arena_type>::type arena;
 
-template <class T2>
+template <class T2, class A2, class Tr2>
 friend class allocator;
 };
 
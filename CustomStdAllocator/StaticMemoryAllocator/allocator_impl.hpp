@@ -1,408 +1,240 @@
-#ifndef NDEBUG
-
-//#define DEBUG_SMA_TRACE_INTERFACE 1
-#define DEBUG_SMA_TRACE_MEMALLOCATION 1
-//#define DEBUG_SMA_TRACE_BITSET 1
-//#define DEBUG_SMA_TRACE_CALC_POINTER_POS 1
-//#define DEBUG_SMA_TRACE_FIND_FREE_MEM 1
-
-#endif /* NDEBUG */
-
 #include "allocator.hpp"
+#include "arena_impl.hpp"
 
-namespace StaticMemoryAllocator {
-
-template <class T>
-allocator<T>::allocator(void *const memstart, const size_type memsize, const std::string & memname) throw()
-	: memstart(memstart),
-	  memfree(std::make_shared<dynamic_bitset>(memsize)),
-	  memname(memname)
-{
-	assert(this->memstart != nullptr);
-	assert(memsize > 0);
-	assert(memfree->size() == memsize);
-	for (size_type i = 0; i < memsize; i++) memfree->set(i);
-	assert(memfree->count() == memsize);
-#	if DEBUG_SMA_TRACE_INTERFACE
-	std::cout << "construct allocator: "
-		  << "start=" << this->memstart << ", "
-		  << "size=" << this->memfree->size() << " bytes, "
-		  << "name='" << this->memname << "'"
-		  << std::endl;
-#	endif
-#       if DEBUG_SMA_TRACE_MEMALLOCATION
-	print_free_memory();
-#	endif
-}
+#include <limits>
 
-template <class T>
-allocator<T>::allocator(const allocator & a)
-	: memstart(a.memstart),
-	  memfree(a.memfree),
-	  memname(a.memname)
-{
-	assert(this->memstart != nullptr);
-#	if DEBUG_SMA_TRACE_INTERFACE
-	std::cout << "copy-construct allocator: "
-		  << "start=" << this->memstart << ", "
-		  << "size=" << this->memfree->size() << " bytes, "
-		  << "name='" << this->memname << "'"
-		  << std::endl;
-#	endif
-#       if DEBUG_SMA_TRACE_MEMALLOCATION
-	print_free_memory();
-#	endif
-}
+namespace StaticMemoryAllocator {
 
-template <class T>
-allocator<T>::allocator(allocator && a)
-	: memstart(a.memstart),
-	  memfree(a.memfree),
-	  memname(a.memname)
+template <class T, class Arena, class Trace>
+allocator<T, Arena, Trace>::allocator(arena_type & a) throw()
+	: arena(&a)
 {
-	assert(this->memstart != nullptr);
-#	if DEBUG_SMA_TRACE_INTERFACE
-	std::cout << "move-construct allocator: "
-		  << "start=" << this->memstart << ", "
-		  << "size=" << this->memfree->size() << " bytes, "
-		  << "name='" << this->memname << "'"
-		  << std::endl;
-#	endif
-#       if DEBUG_SMA_TRACE_MEMALLOCATION
-	print_free_memory();
-#	endif
+	assert(this->arena->memstart() != nullptr);
 }
 
-template <class T>
+template <class T, class Arena, class Trace>
 template <class T2>
-allocator<T>::allocator(const allocator<T2> & a) throw()
-	: memstart(a.memstart),
-	  memfree(a.memfree),
-	  memname(a.memname)
+allocator<T, Arena, Trace>::allocator(const allocator<T2, Arena, Trace> & a) throw()
+	: arena(a.arena)
 {
-	assert(this->memstart != nullptr);
-#	if DEBUG_SMA_TRACE_INTERFACE
-	std::cout << "copy-construct allocator (of different value type): "
-		  << "start=" << this->memstart << ", "
-		  << "size=" << this->memfree->size() << " bytes, "
-		  << "name='" << this->memname << "'"
-		  << std::endl;
-#	endif
-#       if DEBUG_SMA_TRACE_MEMALLOCATION
-	print_free_memory();
-#	endif
+	assert(this->arena->memstart() != nullptr);
 }
 
-template <class T>
-allocator<T>::~allocator() throw()
-{
-#	if DEBUG_SMA_TRACE_INTERFACE
-	std::cout << "destruct allocator: "
-		  << "start=" << this->memstart << ", "
-		  << "size=" << this->memfree->size() << " bytes, "
-		  << "name='" << this->memname << "'"
-		  << std::endl;
-#	endif
-}
-
-template <class T>
-allocator<T> & allocator<T>::operator =(const allocator & a)
+template <class T, class Arena, class Trace>
+template <class T2>
+allocator<T, Arena, Trace> & allocator<T, Arena, Trace>::operator =(const allocator<T2, Arena, Trace> & a)
 {
-#	if DEBUG_SMA_TRACE_INTERFACE
-	std::cout << "copy-assign allocator" << std::endl;
-#	endif
-#       if DEBUG_SMA_TRACE_MEMALLOCATION
-	print_free_memory();
-#	endif
+	arena = a.arena;
 	return *this;
 }
 
-template <class T>
-template <class T2>
-allocator<T> & allocator<T>::operator =(const allocator<T2> & a)
+template <class T, class Arena, class Trace>
+typename allocator<T, Arena, Trace>::pointer allocator<T, Arena, Trace>::address(reference r) const // optional
 {
-#	if DEBUG_SMA_TRACE_INTERFACE
-	std::cout << "copy-assign allocator (of different value type)" << std::endl;
-#	endif
-#       if DEBUG_SMA_TRACE_MEMALLOCATION
-	print_free_memory();
-#	endif
-	return *this;
+	return &r;
 }
 
-template <class T>
-typename allocator<T>::pointer allocator<T>::address(reference r) const // optional
+template <class T, class Arena, class Trace>
+typename allocator<T, Arena, Trace>::const_pointer allocator<T, Arena, Trace>::address(const_reference r) const // optional
 {
-#	if DEBUG_SMA_TRACE_INTERFACE
-	std::cout << "get address" << std::endl;
-#	endif
 	return &r;
 }
 
-template <class T>
-typename allocator<T>::const_pointer allocator<T>::address(const_reference r) const // optional
+template <class T, class Arena, class Trace>
+typename allocator<T, Arena, Trace>::pointer allocator<T, Arena, Trace>::allocate(size_type n, void *const hint)
 {
-#	if DEBUG_SMA_TRACE_INTERFACE
-	std::cout << "get address (const)" << std::endl;
-#	endif
-	return &r;
+	return allocate_aligned(n, alignof(T), hint);
 }
 
-template <class T>
-typename allocator<T>::pointer allocator<T>::allocate(size_type n, void *const hint)
+template <class T, class Arena, class Trace>
+typename allocator<T, Arena, Trace>::pointer allocator<T, Arena, Trace>::allocate_aligned(size_type n, size_type alignment, void *const hint)
 {
 	const size_type nb = n * sizeof(T);
-#	if DEBUG_SMA_TRACE_INTERFACE
-	std::cout << "alloc " << nb << " bytes (n=" << n << ", hint=" << static_cast<void *>(hint) << ")" << std::endl;
-#	endif
+	if (alignment < alignof(T)) alignment = alignof(T);
 	assert(nb > 0);
 	if (!(nb > 0)) {
 		std::cerr << "cannot allocate a memory block of size " << nb << std::endl;
 		goto badalloc;
 	}
-	if (nb > memfree->size()) {
-		std::cerr << "triing to allocate a memory block of size " << nb << " bytes, "
-			  << "but the managed memory has only a size of " << memfree->size() << " bytes." << std::endl;
-		goto badalloc;
-	}
 	{//block
-		auto mask = create_mask(nb, memfree->size());
-		const size_type pos = find_free_memory(*memfree, mask);
-		assert(0 <= pos && pos <= memfree->size());
-		if (pos < memfree->size()) {
-#			if DEBUG_SMA_TRACE_MEMALLOCATION
-			std::cout << "reserved memory: " << mask.count() << " bytes -> "
-				  << (memfree->count() - mask.count()) << " bytes free."
-				  << std::endl;
-#			endif
-			*memfree = reserve_memory(*memfree, std::move(mask));
-#			if DEBUG_SMA_TRACE_MEMALLOCATION
-			print_free_memory();
-#			endif
-			return calc_pointer(memstart, pos);
-		} else {
-#			if DEBUG_SMA_TRACE_MEMALLOCATION
-			std::cout << "not enough free memory to allocate " << nb << " bytes." << std::endl;
-			print_free_memory();
-#			endif
+		void *const p = arena->allocate(nb, alignment, hint);
+		if (p != nullptr) {
+			assert(reinterpret_cast<uintptr_t>(p) % alignment == 0);
+			trace(trace_op::allocate, p, nb);
+			return static_cast<value_type *>(p);
 		}
 	}
 badalloc:
 	/* not enough memory free */
+	trace(trace_op::allocate_failed, nullptr, nb);
 	throw std::bad_alloc();
 	return nullptr;
 }
 
-template <class T>
-void allocator<T>::deallocate(pointer p, size_type n)
+template <class T, class Arena, class Trace>
+void allocator<T, Arena, Trace>::deallocate(pointer p, size_type n)
 {
 	const size_type nb = n * sizeof(T);
-#	if DEBUG_SMA_TRACE_INTERFACE
-	std::cout << "dealloc " << nb << " bytes (n=" << n << ", pointer=" << static_cast<void *>(p) <<")" << std::endl;
-#	endif
+	void *const pmem = std::addressof(*p);
 	assert(nb > 0);
-	const size_type pos = calc_pos(memstart, p);
-	assert(0 <= pos && pos < memfree->size());
-	auto mask = create_mask(nb, memfree->size()) << pos;
-#	if DEBUG_SMA_TRACE_MEMALLOCATION
-	std::cout << "freeed memory: " << mask.count() << " bytes -> "
-		  << (memfree->count() + mask.count()) << " bytes free."
-		  << std::endl;
-#	endif
-	*memfree = free_memory(*memfree, std::move(mask));
-#	if DEBUG_SMA_TRACE_MEMALLOCATION
-	print_free_memory();
-#	endif
+	trace(trace_op::deallocate, pmem, nb);
+	arena->deallocate(pmem, nb);
 }
 
-template <class T>
-typename allocator<T>::size_type allocator<T>::max_size()
+template <class T, class Arena, class Trace>
+void allocator<T, Arena, Trace>::allocate_batch(size_type count, size_type n, pointer *out)
 {
-#	if DEBUG_SMA_TRACE_INTERFACE
-	std::cout << "get max size" << std::endl; 
-#	endif
-	size_type max = 0;
-	size_type k = 0;
-	for (size_type i = 0; i < memfree->size(); i++) {
-		if (memfree->test(i)) {
-			k++;
-		} else {
-			if (k > max) max = k;
-			k = 0;
+	const size_type nb = n * sizeof(T);
+	assert(nb > 0);
+	void *blocks[batch_size];
+	size_type done = 0;
+	while (done < count) {
+		const size_type k = (count - done < batch_size) ? count - done : batch_size;
+		if (!arena_allocate_batch(*arena, k, nb, alignof(T), blocks, 0)) {
+			/* not enough memory free */
+			trace(trace_op::allocate_failed, nullptr, (count - done) * nb);
+			deallocate_batch(out, done, n);
+			throw std::bad_alloc();
+		}
+		for (size_type i = 0; i < k; i++) {
+			trace(trace_op::allocate, blocks[i], nb);
+			out[done + i] = static_cast<value_type *>(blocks[i]);
 		}
+		done += k;
 	}
-#	if DEBUG_SMA_TRACE_MEMALLOCATION
-	std::cout << "max allocatable blocksize is " << max << " bytes." << std::endl;
-#	endif
-	return max;
 }
 
-template <class T>
-template <class U, class... Args>
-void allocator<T>::construct(U *p, Args&&... args) // optional
+template <class T, class Arena, class Trace>
+void allocator<T, Arena, Trace>::deallocate_batch(const pointer *ps, size_type count, size_type n)
 {
-#	if DEBUG_SMA_TRACE_INTERFACE
-	std::cout << "contruct element in allocator at " << static_cast<void *>(p) << std::endl;
-#	endif
-	::new ((void *)p) U(std::forward<Args>(args)...);
+	const size_type nb = n * sizeof(T);
+	assert(nb > 0);
+	void *blocks[batch_size];
+	size_type done = 0;
+	while (done < count) {
+		const size_type k = (count - done < batch_size) ? count - done : batch_size;
+		for (size_type i = 0; i < k; i++) {
+			blocks[i] = std::addressof(*ps[done + i]);
+			trace(trace_op::deallocate, blocks[i], nb);
+		}
+		arena_deallocate_batch(*arena, blocks, k, nb, 0);
+		done += k;
+	}
 }
 
-template <class T>
-template <class U>
-void allocator<T>::destroy(U *p) // optional
+template <class T, class Arena, class Trace>
+template <class A>
+auto allocator<T, Arena, Trace>::arena_allocate_batch(A & a, size_type count, size_type nb, size_type alignment, void **out, int)
+	-> decltype(a.allocate_batch(count, nb, alignment, out))
 {
-#	if DEBUG_SMA_TRACE_INTERFACE
-	std::cout << "destroy element in allocator at " << static_cast<void *>(p) << std::endl;
-#	endif
-	p->~U();
+	return a.allocate_batch(count, nb, alignment, out);
 }
 
-template <class T>
-bool allocator<T>::operator !=(const allocator & a) const
+template <class T, class Arena, class Trace>
+template <class A>
+bool allocator<T, Arena, Trace>::arena_allocate_batch(A & a, size_type count, size_type nb, size_type alignment, void **out, long)
 {
-	if (memfree->size() != a.memfree->size()) return true;
-	for (size_type i = 0; i < memfree->size(); i++) {
-		if (memfree->test(i) != a.memfree->test(i)) return true;
+	for (size_type i = 0; i < count; i++) {
+		out[i] = a.allocate(nb, alignment);
+		if (out[i] == nullptr) {
+			arena_deallocate_batch(a, out, i, nb, 0);
+			return false;
+		}
 	}
-	return false;
+	return true;
 }
 
-template <class T>
-void allocator<T>::print_free_memory(void) const
+template <class T, class Arena, class Trace>
+template <class A>
+auto allocator<T, Arena, Trace>::arena_deallocate_batch(A & a, void *const *ps, size_type count, size_type nb, int)
+	-> decltype(a.deallocate_batch(ps, count, nb))
 {
-	std::cout << "free memory (" << ((memname.empty()) ? "<unnamed>" : memname) << "): " 
-		  << *memfree << " at (" << memend() << ", " << memstart << "]" << std::endl;
+	a.deallocate_batch(ps, count, nb);
 }
 
-template <class T>
-typename allocator<T>::dynamic_bitset allocator<T>::create_mask(const size_type nb, const size_type memsize)
+template <class T, class Arena, class Trace>
+template <class A>
+void allocator<T, Arena, Trace>::arena_deallocate_batch(A & a, void *const *ps, size_type count, size_type nb, long)
 {
-	dynamic_bitset mask(memsize, false);
-	for (size_type i = 0; i < nb; i++) mask.set(i);
-	assert(mask.count() == nb);
-	return mask;
+	for (size_type i = 0; i < count; i++) a.deallocate(ps[i], nb);
 }
 
-template <class T>
-typename allocator<T>::size_type allocator<T>::find_free_memory(const dynamic_bitset & memfree, dynamic_bitset & mask)
+template <class T, class Arena, class Trace>
+bool allocator<T, Arena, Trace>::expand_in_place(pointer p, size_type old_n, size_type new_n)
 {
-	/* search mask in memfree */
-	const size_type needed_mem_size = mask.count();
-	if (memfree.count() < needed_mem_size) {
-#		if DEBUG_SMA_TRACE_FIND_FREE_MEM
-		std::cout << "not enough free memory found" << std::endl;
-#		endif
-		return memfree.size();
-	}
-	assert(needed_mem_size <= memfree.size());
-	const size_type asize = memfree.size() - needed_mem_size;
-	size_type pos = 0;
-	while (pos <= asize) {
-#		if DEBUG_SMA_TRACE_FIND_FREE_MEM
-		std::cout << "pos:     " << pos << "/" << asize << std::endl;
-		std::cout << "mask:    " << mask << std::endl;
-		std::cout << "memfree: " << memfree << std::endl;
-#		endif
-		/* check if enough memory is free in interval [pos, pos+needed_mem_size) */
-		if ((memfree & mask) == mask) {
-			/* free memory found */
-#			if DEBUG_SMA_TRACE_FIND_FREE_MEM
-			std::cout << "free memory found at pos=" << pos << std::endl;
-#			endif
-			return pos;
-		} else {
-			/* increment pos for next iteration */
-#			if DEBUG_SMA_TRACE_FIND_FREE_MEM
-			std::cout << "memfree:  " << memfree << "    "
-				  << memfree << std::endl;
-			std::cout << "inc mask: " << mask << " -> ";
-#			endif
-			const size_type oldpos = pos;
-			pos = memfree.find_next(oldpos);
-			assert(pos >= oldpos);
-			mask <<= pos - oldpos;
-#			if DEBUG_SMA_TRACE_FIND_FREE_MEM
-			std::cout << mask << std::endl;
-			std::cout << "pos: " << oldpos << " -> "
-				  << pos << std::endl;
-#			endif
-			assert(mask.count() == needed_mem_size);
-		}
-	}
-	/* no free memory found */
-#	if DEBUG_SMA_TRACE_FIND_FREE_MEM
-	std::cout << "not enough free memory found" << std::endl;
-#	endif
-	return memfree.size();
+	void *const pmem = std::addressof(*p);
+	assert(old_n > 0 && new_n > 0);
+	if (new_n > std::numeric_limits<size_type>::max() / sizeof(T)) return false;
+	if (!arena->expand(pmem, old_n * sizeof(T), new_n * sizeof(T))) return false;
+	trace(trace_op::expand, pmem, new_n * sizeof(T));
+	return true;
 }
 
-template <class T>
-void *const allocator<T>::memend() const
+template <class T, class Arena, class Trace>
+bool allocator<T, Arena, Trace>::shrink_in_place(pointer p, size_type old_n, size_type new_n)
 {
-	assert(memstart != nullptr);
-	byte *const mem = static_cast<byte *>(memstart);
-	void *const mend = &mem[memfree->size()];
-	assert(mend != nullptr);
-	return mend;
+	void *const pmem = std::addressof(*p);
+	assert(old_n > 0 && new_n > 0);
+	if (!arena->shrink(pmem, old_n * sizeof(T), new_n * sizeof(T))) return false;
+	trace(trace_op::shrink, pmem, new_n * sizeof(T));
+	return true;
 }
 
-template <class T>
-typename allocator<T>::pointer allocator<T>::calc_pointer(void *const start, const size_type pos)
+template <class T, class Arena, class Trace>
+typename allocator<T, Arena, Trace>::size_type allocator<T, Arena, Trace>::max_size()
 {
-	assert(start != nullptr);
-	byte *const mem = static_cast<byte *>(start);
-	void *pmem = &mem[pos];
-#	if DEBUG_SMA_TRACE_CALC_POINTER_POS
-	std::cout << "calc pointer(start=" << start << ", pos=" << pos << ") --> " << pmem << std::endl;
-#	endif
-	assert(pmem != nullptr);
-	return static_cast<pointer>(pmem);
+	return arena->max_size();
 }
 
-template <class T>
-typename allocator<T>::size_type allocator<T>::calc_pos(void *const start, void *const pmem)
+template <class T, class Arena, class Trace>
+template <class U, class... Args>
+void allocator<T, Arena, Trace>::construct(U *p, Args&&... args) // optional
 {
-	assert(start != nullptr);
-	assert(pmem != nullptr);
-	byte *const mem = static_cast<byte *>(start);
-	byte *const p = static_cast<byte *>(pmem);
-	assert(p >= mem);
-	const size_type pos = static_cast<size_type>(p - mem);
-#	if DEBUG_SMA_TRACE_CALC_POINTER_POS
-	std::cout << "calc pos(start=" << start << ", p=" << pmem << ") --> " << pos << std::endl;
-#	endif
-	return pos;
+	::new ((void *)p) U(std::forward<Args>(args)...);
 }
 
-template <class T>
-typename allocator<T>::dynamic_bitset allocator<T>::reserve_memory(const dynamic_bitset & memfree,
-	                                                           dynamic_bitset && mask)
+template <class T, class Arena, class Trace>
+template <class U>
+void allocator<T, Arena, Trace>::destroy(U *p) // optional
 {
-	auto res = memfree & ~mask;
-#	if DEBUG_SMA_TRACE_BITSET
-	std::cout << "a=memfree: " << memfree << std::endl;
-	std::cout << "b=   mask: " << mask << std::endl;
-	std::cout << "r= a & ~b: " << res << std::endl;
-#	endif
-	assert(memfree.count() - mask.count() == res.count());
-	return res;
+	p->~U();
 }
 
-template <class T>
-typename allocator<T>::dynamic_bitset allocator<T>::free_memory(const dynamic_bitset & memfree,
-	                                                        dynamic_bitset && mask)
+template <class T, class Arena, class Trace>
+template <class T2>
+bool allocator<T, Arena, Trace>::operator ==(const allocator<T2, Arena, Trace> & a) const
 {
-	assert(memfree.size() == mask.size());
-	assert(memfree.count() + mask.count() <= memfree.size());
-	auto res = memfree | mask;
-#	if DEBUG_SMA_TRACE_BITSET
-	std::cout << "a=memfree: " << memfree << std::endl;
-	std::cout << "b=   mask: " << mask << std::endl;
-	std::cout << "r=  a | b: " << res << std::endl;
-#	endif
-	assert(memfree.count() + mask.count() == res.count());
-	return res;
+	return arena == a.arena;
 }
 
-} /* namespace StaticMemoryAllocator */
+template <class T, class Arena, class Trace>
+template <class T2>
+bool allocator<T, Arena, Trace>::operator !=(const allocator<T2, Arena, Trace> & a) const
+{
+	return arena != a.arena;
+}
 
+template <class T, class Arena, class Trace>
+void *const allocator<T, Arena, Trace>::memend() const
+{
+	return arena->memend();
+}
+
+template <class T, class Arena, class Trace>
+void allocator<T, Arena, Trace>::print_free_memory(void) const
+{
+	arena->print_free_memory();
+}
+
+template <class T, class Arena, class Trace>
+void allocator<T, Arena, Trace>::trace(const trace_op op, const void *const p, const size_type nb) const
+{
+	/* the condition is known at compile time: nothing is left for null_trace */
+	if (!Trace::enabled) return;
+	const uint64_t offset = (p != nullptr)
+		? static_cast<const uint8_t *>(p) - static_cast<const uint8_t *>(arena->memstart())
+		: 0;
+	Trace::record(op, std::addressof(*arena), offset, nb);
+}
+
+} /* namespace StaticMemoryAllocator */
@@ -0,0 +1,245 @@
+#ifndef STATIC_MEMORY_ALLOCATOR__ARENA_H__AD_
+#define STATIC_MEMORY_ALLOCATOR__ARENA_H__AD_
+
+/**
+ * \file StaticMemoryAllocator\arena.hpp
+ * \author Angelos Drossos <angelos.drossos@gmail.com>
+ */
+
+#include "arena_stats.hpp"
+#include "bitmap.hpp"
+#include "concurrent_bitmap.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <type_traits>
+
+namespace StaticMemoryAllocator {
+
+/**
+ * Size of a cache line, e.g. to be used as alignment of hot structures.
+ */
+static const std::size_t cache_line_size = 64;
+
+/**
+ * Type of a pointer to \p T into the memory block of an arena,
+ * which the allocator uses as its pointer type (and to point to its arena).
+ *
+ * A plain pointer for all arenas, but those whose memory block can be
+ * mapped at different addresses (e.g. mapped_arena, whose pointers are offset_ptr).
+ */
+template <class Arena, class T>
+struct arena_pointer
+{
+	typedef T *type;
+};
+
+/**
+ * Manages a static memory block [memstart, memend()) by a bitmap,
+ * one bit per granule of \p Granule bytes.
+ *
+ * All allocators of the same memory block share one arena.
+ * A bigger granule reduces the size of the bitmap
+ * (e.g. 64 bytes granules cost 1 bit per 64 bytes),
+ * but each allocation is rounded up to whole granules.
+ * The start of the managed block is aligned to the granule size.
+ *
+ * \tparam Granule Size of a granule in bytes (a power of two).
+ * \tparam Bitmap Type of the bitmap: bitmap (the arena must not be used
+ *         by several threads at the same time), or concurrent_bitmap.
+ */
+template <std::size_t Granule = 1, class Bitmap = bitmap>
+class bitmap_arena
+{
+	static_assert(Granule > 0 && (Granule & (Granule - 1)) == 0,
+	              "the granule size has to be a power of two");
+
+private:
+	typedef uint8_t                            byte;
+	typedef Bitmap                             bitmap_type;
+
+public:
+	typedef std::size_t        size_type;
+
+	static const size_type granule_size = Granule;
+
+	/**
+	 * Distance in bytes from a hint, within which a memory block is placed near it.
+	 */
+	static const size_type hint_window = 16 * 4096;
+
+/* constructors, destructors, assignment operators */
+public:
+
+	bitmap_arena() = delete;
+
+	bitmap_arena(void *const memstart, const size_type memsize, const std::string & memname = "");
+
+	bitmap_arena(const bitmap_arena & a) = delete;
+
+	bitmap_arena & operator =(const bitmap_arena & a) = delete;
+
+/* arena functions */
+public:
+
+	/**
+	 * Reserves a memory block of (at least) \p nb bytes.
+	 *
+	 * \param nb Size of the memory block in bytes.
+	 * \param alignment Alignment of the memory block (a power of two).
+	 * \param hint Pointer into the managed memory block (e.g. to a neighbouring
+	 *        node), or nullptr: the memory block is placed near the hint,
+	 *        searching outward from it (in windows behind and in front of it,
+	 *        which double up to hint_window bytes, the closer free memory
+	 *        block of both sides is taken), otherwise at the first fit.
+	 * \return Pointer to the memory block, or nullptr if there is no
+	 *         large enough (and aligned) free memory block.
+	 */
+	void *allocate(const size_type nb, const size_type alignment, void *const hint = nullptr);
+
+	/**
+	 * Frees the memory block of \p nb bytes at \p p
+	 * (which was reserved by allocate()).
+	 */
+	void deallocate(void *const p, const size_type nb);
+
+	/**
+	 * Reserves \p n memory blocks of (at least) \p nb bytes each and stores
+	 * their pointers to \p out. As many blocks as fit into a free run are
+	 * claimed together, i.e. the bitmap is searched and updated once per run
+	 * (word by word), not once per block.
+	 * Either all or none of the blocks are reserved.
+	 *
+	 * \return false (and nothing reserved), if there is not enough free memory.
+	 */
+	bool allocate_batch(const size_type n, const size_type nb, const size_type alignment, void **const out);
+
+	/**
+	 * Frees the \p n memory blocks of \p nb bytes at \p ps.
+	 * Neighbouring blocks (e.g. of allocate_batch()) are freed together.
+	 */
+	void deallocate_batch(void *const *const ps, const size_type n, const size_type nb);
+
+	/**
+	 * Grows the memory block of \p old_nb bytes at \p p to \p new_nb bytes,
+	 * if the granules behind it are free (the block is not moved).
+	 *
+	 * \return false (and nothing changed), if the block cannot grow in place.
+	 */
+	bool expand(void *const p, const size_type old_nb, const size_type new_nb);
+
+	/**
+	 * Shrinks the memory block of \p old_nb bytes at \p p to \p new_nb bytes
+	 * (the granules behind it are freed).
+	 *
+	 * \return true, the block can always shrink in place.
+	 */
+	bool shrink(void *const p, const size_type old_nb, const size_type new_nb);
+
+	/**
+	 * Returns the size of the largest free memory block in bytes.
+	 * The bitmap keeps it up to date on each update (the concurrent_bitmap
+	 * cannot, it searches the longest free run on each call).
+	 */
+	size_type max_size(void) const;
+
+	/**
+	 * Returns the number of free bytes (in all free memory blocks).
+	 */
+	size_type available(void) const;
+
+	/**
+	 * Returns the statistics of the arena. The counters are kept up to date
+	 * by each allocation and deallocation (by relaxed atomics, thus stats()
+	 * can be called by another thread), stats() does not search the bitmap
+	 * (but the largest free block of a concurrent_bitmap, see max_size()).
+	 * For a concurrent_bitmap, the number of free fragments is approximate.
+	 */
+	arena_stats stats(void) const;
+
+	/**
+	 * Returns the size of the managed memory block in bytes.
+	 */
+	size_type size(void) const;
+
+	void *const memstart(void) const;
+
+	void *const memend(void) const;
+
+	const std::string & name(void) const;
+
+	bool operator ==(const bitmap_arena & a) const;
+
+	void print_free_memory(void) const;
+
+private:
+
+	static
+	void *align_start(void *const memstart);
+
+	static
+	size_type calc_granules(const size_type nb);
+
+	static
+	size_type calc_memsize(void *const memstart, const size_type memsize);
+
+	size_type find_free_memory(const size_type ng, const size_type alignment,
+	                           const size_type from, const size_type to) const;
+
+	size_type find_free_memory_near(const size_type ng, const size_type alignment, void *const hint) const;
+
+	void *calc_pointer(const size_type mempos) const;
+
+	size_type calc_pos(void *const pmem) const;
+
+	/* reserves a block of ng granules (aligned to alignment, near hint) */
+	void *reserve_block(const size_type ng, const size_type alignment, void *const hint);
+
+	/* frees the n blocks of ng granules at ps */
+	void free_blocks(void *const *const ps, const size_type n, const size_type ng);
+
+	bool reserve_memory(const size_type pos, const size_type ng);
+
+	void free_memory(const size_type pos, const size_type ng);
+
+	/* the counters of stats() */
+	struct counters
+	{
+		std::atomic<uint64_t> allocations;
+		std::atomic<uint64_t> deallocations;
+		std::atomic<uint64_t> failed_allocations;
+		std::atomic<uint64_t> bytes_in_use;
+		std::atomic<uint64_t> peak_bytes_in_use;
+		std::atomic<uint64_t> free_fragments;
+		std::atomic<uint64_t> size_histogram[arena_stats::histogram_buckets];
+	};
+
+	/* counters are only updated atomically, if several threads update them */
+	static const bool concurrent = std::is_same<Bitmap, concurrent_bitmap>::value;
+
+	void count_requests(const size_type nb, const size_type n);
+
+	static
+	void add(std::atomic<uint64_t> & counter, const uint64_t delta);
+
+/* member variables */
+private:
+
+	void *start;
+	bitmap_type memfree;
+	std::string memname;
+	counters memstats;
+};
+
+/**
+ * Arena, which can be shared by allocators of several threads:
+ * free memory is claimed and released by atomic operations
+ * on the bitmap words (without any mutex).
+ */
+template <std::size_t Granule = 1>
+using concurrent_arena = bitmap_arena<Granule, concurrent_bitmap>;
+
+} /* namespace StaticMemoryAllocator */
+#endif /* STATIC_MEMORY_ALLOCATOR__ARENA_H__AD_ */
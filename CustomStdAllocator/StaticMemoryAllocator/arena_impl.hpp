@@ -0,0 +1,416 @@
+#ifndef STATIC_MEMORY_ALLOCATOR__ARENA_IMPL_H__AD_
+#define STATIC_MEMORY_ALLOCATOR__ARENA_IMPL_H__AD_
+
+#include "arena.hpp"
+
+#include <algorithm>
+#include <iostream>
+
+#include <assert.h>
+
+namespace StaticMemoryAllocator {
+
+template <std::size_t Granule, class Bitmap>
+bitmap_arena<Granule, Bitmap>::bitmap_arena(void *const memstart, const size_type memsize, const std::string & memname)
+	: start(align_start(memstart)),
+	  memfree(calc_memsize(memstart, memsize), true),
+	  memname(memname),
+	  memstats()
+{
+	assert(this->start != nullptr);
+	assert(memfree.size() > 0);
+	assert(memfree.count() == memfree.size());
+	/* all memory is one free run */
+	memstats.free_fragments.store(1, std::memory_order_relaxed);
+}
+
+template <std::size_t Granule, class Bitmap>
+void *bitmap_arena<Granule, Bitmap>::allocate(const size_type nb, const size_type alignment, void *const hint)
+{
+	assert(nb > 0);
+	assert(alignment > 0 && (alignment & (alignment - 1)) == 0);
+	const size_type ng = calc_granules(nb);
+	count_requests(nb, 1);
+	if (ng > memfree.size()) {
+		std::cerr << "triing to allocate a memory block of size " << nb << " bytes, "
+			  << "but the managed memory has only a size of " << size() << " bytes." << std::endl;
+		add(memstats.failed_allocations, 1);
+		return nullptr;
+	}
+	void *const p = reserve_block(ng, alignment, hint);
+	add((p != nullptr) ? memstats.allocations : memstats.failed_allocations, 1);
+	return p;
+}
+
+template <std::size_t Granule, class Bitmap>
+void bitmap_arena<Granule, Bitmap>::deallocate(void *const p, const size_type nb)
+{
+	assert(nb > 0);
+	const size_type ng = calc_granules(nb);
+	const size_type pos = calc_pos(p);
+	assert(0 <= pos && pos < memfree.size());
+	free_memory(pos, ng);
+	add(memstats.deallocations, 1);
+}
+
+template <std::size_t Granule, class Bitmap>
+bool bitmap_arena<Granule, Bitmap>::allocate_batch(const size_type n, const size_type nb, const size_type alignment, void **const out)
+{
+	assert(nb > 0);
+	assert(alignment > 0 && (alignment & (alignment - 1)) == 0);
+	const size_type ng = calc_granules(nb);
+	const size_type stride = (alignment > Granule) ? alignment / Granule : 1;
+	count_requests(nb, n);
+	size_type done = 0;
+	if (n > memfree.count() / ng) {
+		/* more blocks than the free memory, nothing to search */
+	} else if (ng % stride != 0) {
+		/* the blocks of a run would not stay aligned: reserve them one by one */
+		for (; done < n; done++) {
+			out[done] = reserve_block(ng, alignment, nullptr);
+			if (out[done] == nullptr) break;
+		}
+	} else {
+		size_type pos = 0;
+		while (done < n) {
+			const size_type first = find_free_memory(ng, alignment, pos, memfree.size());
+			if (!(first < memfree.size())) break;
+			/* all blocks fitting into the free run are claimed together */
+			const size_type run = memfree.find_first_zero(first) - first;
+			assert(run >= ng);
+			const size_type k = std::min(run / ng, n - done);
+			/* reserving fails, if another thread reserved (a part of) the run in the meantime */
+			if (!reserve_memory(first, k * ng)) {
+				pos = first;
+				continue;
+			}
+			for (size_type i = 0; i < k; i++) out[done + i] = calc_pointer(first + i * ng);
+			done += k;
+			pos = first + k * ng;
+		}
+	}
+	if (done < n) {
+		free_blocks(out, done, ng);
+		add(memstats.failed_allocations, n);
+		return false;
+	}
+	add(memstats.allocations, n);
+	return true;
+}
+
+template <std::size_t Granule, class Bitmap>
+void bitmap_arena<Granule, Bitmap>::deallocate_batch(void *const *const ps, const size_type n, const size_type nb)
+{
+	assert(nb > 0);
+	free_blocks(ps, n, calc_granules(nb));
+	add(memstats.deallocations, n);
+}
+
+template <std::size_t Granule, class Bitmap>
+void bitmap_arena<Granule, Bitmap>::free_blocks(void *const *const ps, const size_type n, const size_type ng)
+{
+	if (n == 0) return;
+	/* blocks following each other (upwards or downwards) are freed as one run */
+	size_type first = calc_pos(ps[0]);
+	size_type last = first + ng;
+	for (size_type i = 1; i < n; i++) {
+		const size_type pos = calc_pos(ps[i]);
+		if (pos == last) {
+			last += ng;
+		} else if (pos + ng == first) {
+			first = pos;
+		} else {
+			free_memory(first, last - first);
+			first = pos;
+			last = pos + ng;
+		}
+	}
+	free_memory(first, last - first);
+}
+
+template <std::size_t Granule, class Bitmap>
+bool bitmap_arena<Granule, Bitmap>::expand(void *const p, const size_type old_nb, const size_type new_nb)
+{
+	assert(old_nb > 0 && new_nb > 0);
+	const size_type old_ng = calc_granules(old_nb);
+	const size_type new_ng = calc_granules(new_nb);
+	if (new_ng <= old_ng) return true;
+	const size_type pos = calc_pos(p);
+	assert(0 <= pos && pos < memfree.size());
+	if (new_ng > memfree.size() - pos) return false;
+	if (!reserve_memory(pos + old_ng, new_ng - old_ng)) return false;
+	return true;
+}
+
+template <std::size_t Granule, class Bitmap>
+bool bitmap_arena<Granule, Bitmap>::shrink(void *const p, const size_type old_nb, const size_type new_nb)
+{
+	assert(old_nb > 0 && new_nb > 0);
+	const size_type old_ng = calc_granules(old_nb);
+	const size_type new_ng = calc_granules(new_nb);
+	if (new_ng >= old_ng) return true;
+	const size_type pos = calc_pos(p);
+	assert(0 <= pos && pos < memfree.size());
+	free_memory(pos + new_ng, old_ng - new_ng);
+	return true;
+}
+
+template <std::size_t Granule, class Bitmap>
+typename bitmap_arena<Granule, Bitmap>::size_type bitmap_arena<Granule, Bitmap>::max_size(void) const
+{
+	return memfree.longest_run() * Granule;
+}
+
+template <std::size_t Granule, class Bitmap>
+typename bitmap_arena<Granule, Bitmap>::size_type bitmap_arena<Granule, Bitmap>::available(void) const
+{
+	return memfree.count() * Granule;
+}
+
+template <std::size_t Granule, class Bitmap>
+arena_stats bitmap_arena<Granule, Bitmap>::stats(void) const
+{
+	arena_stats s;
+	s.allocations = memstats.allocations.load(std::memory_order_relaxed);
+	s.deallocations = memstats.deallocations.load(std::memory_order_relaxed);
+	s.failed_allocations = memstats.failed_allocations.load(std::memory_order_relaxed);
+	s.size = size();
+	s.bytes_in_use = memstats.bytes_in_use.load(std::memory_order_relaxed);
+	s.peak_bytes_in_use = memstats.peak_bytes_in_use.load(std::memory_order_relaxed);
+	s.free_bytes = available();
+	s.largest_free = max_size();
+	s.free_fragments = memstats.free_fragments.load(std::memory_order_relaxed);
+	s.fragmentation = (s.free_bytes > 0)
+		? 1.0 - static_cast<double>(s.largest_free) / static_cast<double>(s.free_bytes)
+		: 0.0;
+	for (size_type i = 0; i < arena_stats::histogram_buckets; i++) {
+		s.size_histogram[i] = memstats.size_histogram[i].load(std::memory_order_relaxed);
+	}
+	return s;
+}
+
+template <std::size_t Granule, class Bitmap>
+typename bitmap_arena<Granule, Bitmap>::size_type bitmap_arena<Granule, Bitmap>::size(void) const
+{
+	return memfree.size() * Granule;
+}
+
+template <std::size_t Granule, class Bitmap>
+void *const bitmap_arena<Granule, Bitmap>::memstart(void) const
+{
+	return start;
+}
+
+template <std::size_t Granule, class Bitmap>
+void *const bitmap_arena<Granule, Bitmap>::memend(void) const
+{
+	assert(start != nullptr);
+	byte *const mem = static_cast<byte *>(start);
+	void *const mend = &mem[size()];
+	assert(mend != nullptr);
+	return mend;
+}
+
+template <std::size_t Granule, class Bitmap>
+const std::string & bitmap_arena<Granule, Bitmap>::name(void) const
+{
+	return memname;
+}
+
+template <std::size_t Granule, class Bitmap>
+bool bitmap_arena<Granule, Bitmap>::operator ==(const bitmap_arena & a) const
+{
+	return memfree == a.memfree;
+}
+
+template <std::size_t Granule, class Bitmap>
+void bitmap_arena<Granule, Bitmap>::print_free_memory(void) const
+{
+	std::cout << "free memory (" << ((memname.empty()) ? "<unnamed>" : memname) << "): " 
+		  << memfree << " at (" << memend() << ", " << start << "]" << std::endl;
+}
+
+template <std::size_t Granule, class Bitmap>
+void *bitmap_arena<Granule, Bitmap>::align_start(void *const memstart)
+{
+	assert(memstart != nullptr);
+	const uintptr_t addr = reinterpret_cast<uintptr_t>(memstart);
+	const uintptr_t aligned = (addr + Granule - 1) & ~static_cast<uintptr_t>(Granule - 1);
+	return reinterpret_cast<void *>(aligned);
+}
+
+template <std::size_t Granule, class Bitmap>
+typename bitmap_arena<Granule, Bitmap>::size_type bitmap_arena<Granule, Bitmap>::calc_granules(const size_type nb)
+{
+	return (nb + Granule - 1) / Granule;
+}
+
+template <std::size_t Granule, class Bitmap>
+typename bitmap_arena<Granule, Bitmap>::size_type bitmap_arena<Granule, Bitmap>::calc_memsize(void *const memstart, const size_type memsize)
+{
+	/* the bytes in front of the first aligned granule are not used */
+	const size_type skipped = static_cast<byte *>(align_start(memstart)) - static_cast<byte *>(memstart);
+	assert(skipped < memsize);
+	return (skipped < memsize) ? (memsize - skipped) / Granule : 0;
+}
+
+template <std::size_t Granule, class Bitmap>
+typename bitmap_arena<Granule, Bitmap>::size_type bitmap_arena<Granule, Bitmap>::find_free_memory(const size_type ng, const size_type alignment,
+                                                                                                   const size_type from, const size_type to) const
+{
+	/*
+	 * search the first run of ng free granules in memfree,
+	 * which starts in [from, to) at a granule aligned to alignment:
+	 * each granule is aligned to the granule size (since start is),
+	 * for larger alignments only each stride-th granule is aligned.
+	 */
+	assert(ng > 0);
+	const size_type stride = (alignment > Granule) ? alignment / Granule : 1;
+	const size_type offset = (stride > 1)
+		? ((alignment - reinterpret_cast<uintptr_t>(start) % alignment) % alignment) / Granule
+		: 0;
+	assert(to <= memfree.size());
+	size_type pos = from;
+	for (;;) {
+		const size_type first = memfree.find_run(ng, pos);
+		if (first >= to) break;
+		const size_type aligned = first + (offset + stride - first % stride) % stride;
+		if (aligned >= to || aligned + ng > memfree.size()) break;
+		if (memfree.all(aligned, ng)) {
+			return aligned;
+		}
+		/* the run starting at first is too short behind the aligned granule, continue behind it */
+		pos = memfree.find_first_zero(aligned);
+	}
+	return memfree.size();
+}
+
+template <std::size_t Granule, class Bitmap>
+typename bitmap_arena<Granule, Bitmap>::size_type bitmap_arena<Granule, Bitmap>::find_free_memory_near(const size_type ng, const size_type alignment, void *const hint) const
+{
+	/* a hint outside of the managed memory block is ignored */
+	byte *const mem = static_cast<byte *>(start);
+	byte *const h = static_cast<byte *>(hint);
+	if (h < mem || h >= static_cast<byte *>(memend())) return find_free_memory(ng, alignment, 0, memfree.size());
+	const size_type hpos = static_cast<size_type>(h - mem) / Granule;
+	const size_type window = (hint_window / Granule > 0) ? hint_window / Granule : 1;
+	/*
+	 * search outward from the hint: both windows are doubled until a free
+	 * memory block is found on one side. The first fit in front of the hint
+	 * lies in the part, which the smaller window did not cover,
+	 * thus it is at most twice as far away from the hint as the closest one.
+	 */
+	for (size_type w = std::min<size_type>(64, window); ; w = std::min(2 * w, window)) {
+		const size_type behind = find_free_memory(ng, alignment, hpos, std::min(hpos + w, memfree.size()));
+		const size_type before = find_free_memory(ng, alignment, (hpos > w) ? hpos - w : 0, hpos);
+		if (behind < memfree.size() && before < memfree.size()) {
+			/* the gaps between the hint and the memory blocks */
+			const size_type gap_behind = behind - hpos;
+			const size_type gap_before = (before + ng < hpos) ? hpos - (before + ng) : 0;
+			return (gap_before < gap_behind) ? before : behind;
+		}
+		if (behind < memfree.size()) return behind;
+		if (before < memfree.size()) return before;
+		if (w >= window) break;
+	}
+	return find_free_memory(ng, alignment, 0, memfree.size());
+}
+
+template <std::size_t Granule, class Bitmap>
+void *bitmap_arena<Granule, Bitmap>::calc_pointer(const size_type pos) const
+{
+	assert(start != nullptr);
+	byte *const mem = static_cast<byte *>(start);
+	void *pmem = &mem[pos * Granule];
+	assert(pmem != nullptr);
+	return pmem;
+}
+
+template <std::size_t Granule, class Bitmap>
+typename bitmap_arena<Granule, Bitmap>::size_type bitmap_arena<Granule, Bitmap>::calc_pos(void *const pmem) const
+{
+	assert(start != nullptr);
+	assert(pmem != nullptr);
+	byte *const mem = static_cast<byte *>(start);
+	byte *const p = static_cast<byte *>(pmem);
+	assert(p >= mem);
+	assert((p - mem) % Granule == 0);
+	const size_type pos = static_cast<size_type>(p - mem) / Granule;
+	return pos;
+}
+
+template <std::size_t Granule, class Bitmap>
+void *bitmap_arena<Granule, Bitmap>::reserve_block(const size_type ng, const size_type alignment, void *const hint)
+{
+	/* requests larger than the free memory are rejected without a search */
+	while (ng <= memfree.count()) {
+		const size_type pos = (hint != nullptr)
+			? find_free_memory_near(ng, alignment, hint)
+			: find_free_memory(ng, alignment, 0, memfree.size());
+		assert(0 <= pos && pos <= memfree.size());
+		if (!(pos < memfree.size())) break;
+		/* reserving fails, if another thread reserved (a part of) the memory in the meantime */
+		if (reserve_memory(pos, ng)) {
+			return calc_pointer(pos);
+		}
+	}
+	return nullptr;
+}
+
+template <std::size_t Granule, class Bitmap>
+bool bitmap_arena<Granule, Bitmap>::reserve_memory(const size_type pos, const size_type ng)
+{
+	if (!memfree.try_reset(pos, ng)) return false;
+	/* the free run is split: free granules may be left in front of and behind the reserved ones */
+	const bool before = pos > 0 && memfree.test(pos - 1);
+	const bool behind = pos + ng < memfree.size() && memfree.test(pos + ng);
+	if (before != behind) {
+		/* one of both is left, the number of free runs is unchanged */
+	} else {
+		add(memstats.free_fragments, before ? 1 : -static_cast<uint64_t>(1));
+	}
+	add(memstats.bytes_in_use, ng * Granule);
+	/* the peak only grows, thus it is rarely written */
+	const uint64_t used = memstats.bytes_in_use.load(std::memory_order_relaxed);
+	uint64_t peak = memstats.peak_bytes_in_use.load(std::memory_order_relaxed);
+	while (used > peak && !memstats.peak_bytes_in_use.compare_exchange_weak(peak, used, std::memory_order_relaxed)) {
+	}
+	return true;
+}
+
+template <std::size_t Granule, class Bitmap>
+void bitmap_arena<Granule, Bitmap>::free_memory(const size_type pos, const size_type ng)
+{
+	assert(pos + ng <= memfree.size());
+	assert(memfree.find_first(pos) >= pos + ng);
+	memfree.set(pos, ng);
+	/* the freed granules join the free runs in front of and behind them */
+	const bool before = pos > 0 && memfree.test(pos - 1);
+	const bool behind = pos + ng < memfree.size() && memfree.test(pos + ng);
+	if (before != behind) {
+		/* the granules extend one free run, the number of free runs is unchanged */
+	} else {
+		add(memstats.free_fragments, before ? -static_cast<uint64_t>(1) : 1);
+	}
+	add(memstats.bytes_in_use, -static_cast<uint64_t>(ng * Granule));
+}
+
+template <std::size_t Granule, class Bitmap>
+void bitmap_arena<Granule, Bitmap>::count_requests(const size_type nb, const size_type n)
+{
+	add(memstats.size_histogram[arena_stats::histogram_bucket(nb)], n);
+}
+
+template <std::size_t Granule, class Bitmap>
+void bitmap_arena<Granule, Bitmap>::add(std::atomic<uint64_t> & counter, const uint64_t delta)
+{
+	if (concurrent) {
+		counter.fetch_add(delta, std::memory_order_relaxed);
+	} else {
+		/* only one thread updates the counters, other threads may read them */
+		counter.store(counter.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+	}
+}
+
+} /* namespace StaticMemoryAllocator */
+#endif /* STATIC_MEMORY_ALLOCATOR__ARENA_IMPL_H__AD_ */
@@ -0,0 +1,36 @@
+/**
+ * \file StaticMemoryAllocator\arena_stats.cpp
+ * \author Angelos Drossos <angelos.drossos@gmail.com>
+ */
+#include "arena_stats.hpp"
+#include "bitops.hpp"
+
+namespace StaticMemoryAllocator {
+
+std::size_t arena_stats::histogram_bucket(const std::size_t nb)
+{
+	if (nb == 0) return 0;
+	const std::size_t b = bitops::msb(nb);
+	return (b < histogram_buckets) ? b : histogram_buckets - 1;
+}
+
+std::ostream & operator <<(std::ostream & os, const arena_stats & s)
+{
+	os << "allocations " << s.allocations << "\n"
+	   << "deallocations " << s.deallocations << "\n"
+	   << "failed_allocations " << s.failed_allocations << "\n"
+	   << "size " << s.size << "\n"
+	   << "bytes_in_use " << s.bytes_in_use << "\n"
+	   << "peak_bytes_in_use " << s.peak_bytes_in_use << "\n"
+	   << "free_bytes " << s.free_bytes << "\n"
+	   << "largest_free " << s.largest_free << "\n"
+	   << "free_fragments " << s.free_fragments << "\n"
+	   << "fragmentation " << s.fragmentation << "\n";
+	for (std::size_t i = 0; i < arena_stats::histogram_buckets; i++) {
+		if (s.size_histogram[i] == 0) continue;
+		os << "size_histogram_" << (static_cast<uint64_t>(1) << i) << " " << s.size_histogram[i] << "\n";
+	}
+	return os;
+}
+
+} /* namespace StaticMemoryAllocator */
@@ -0,0 +1,69 @@
+#ifndef STATIC_MEMORY_ALLOCATOR__ARENA_STATS_H__AD_
+#define STATIC_MEMORY_ALLOCATOR__ARENA_STATS_H__AD_
+
+/**
+ * \file StaticMemoryAllocator\arena_stats.hpp
+ * \author Angelos Drossos <angelos.drossos@gmail.com>
+ */
+
+#include <cstdint>
+#include <cstddef>
+#include <ostream>
+
+namespace StaticMemoryAllocator {
+
+/**
+ * Snapshot of the statistics of an arena (see bitmap_arena::stats()).
+ *
+ * The counters are read one by one while the arena may be in use,
+ * thus they need not be consistent with each other exactly.
+ */
+struct arena_stats
+{
+	/* buckets of the histogram of request sizes */
+	static const std::size_t histogram_buckets = 32;
+
+	/* number of successful allocations (a batch counts each block) */
+	uint64_t allocations;
+	/* number of deallocations */
+	uint64_t deallocations;
+	/* number of allocations, which failed since there was no large enough free memory block */
+	uint64_t failed_allocations;
+	/* size of the managed memory block in bytes */
+	uint64_t size;
+	/* bytes reserved (in whole granules) */
+	uint64_t bytes_in_use;
+	/* maximum of bytes_in_use so far */
+	uint64_t peak_bytes_in_use;
+	/* free bytes (size - bytes_in_use) */
+	uint64_t free_bytes;
+	/* size of the largest free memory block in bytes */
+	uint64_t largest_free;
+	/* number of free memory blocks (runs of free granules) */
+	uint64_t free_fragments;
+	/*
+	 * 1 - largest_free / free_bytes: 0 if all free memory is one block,
+	 * close to 1 if it is split into many small blocks
+	 */
+	double fragmentation;
+	/*
+	 * number of requests of [2^i, 2^(i+1)) bytes in bucket i,
+	 * the last bucket counts all larger requests as well
+	 */
+	uint64_t size_histogram[histogram_buckets];
+
+	/**
+	 * Returns the bucket of the histogram of a request of \p nb bytes.
+	 */
+	static
+	std::size_t histogram_bucket(const std::size_t nb);
+};
+
+/**
+ * Prints the statistics as "name value" lines (e.g. to be scraped),
+ * the non-empty buckets of the histogram as "size_histogram_<lower bound> count".
+ */
+std::ostream & operator <<(std::ostream & os, const arena_stats & s);
+
+} /* namespace StaticMemoryAllocator */
+#endif /* STATIC_MEMORY_ALLOCATOR__ARENA_STATS_H__AD_ */
@@ -0,0 +1,378 @@
+/**
+ * \file StaticMemoryAllocator\bitmap.cpp
+ * \author Angelos Drossos <angelos.drossos@gmail.com>
+ */
+#include "bitmap.hpp"
+#include "bitops.hpp"
+
+#include <algorithm>
+
+#include <assert.h>
+
+namespace StaticMemoryAllocator {
+
+namespace {
+
+using namespace bitops;
+
+const size_type bpw = bitmap::bits_per_word;
+const size_type bpsb = bitmap::bits_per_superblock;
+
+inline size_type leaf_count(const size_type nbits)
+{
+	const size_type nsb = std::max<size_type>((nbits + bpsb - 1) / bpsb, 1);
+	size_type n = 1;
+	while (n < nsb) n <<= 1;
+	return n;
+}
+
+/* largest power of two less or equal to n (i.e., the first node of the level of node n) */
+inline size_type level_start(const size_type n)
+{
+	assert(n > 0);
+	size_type p = 1;
+	while ((p << 1) <= n) p <<= 1;
+	return p;
+}
+
+} /* anonymous namespace */
+
+bitmap::bitmap(const size_type nbits, const bool value)
+	: nbits(nbits),
+	  words(word_count(nbits), value ? all_ones : 0),
+	  nonempty(word_count(word_count(nbits)), 0),
+	  nleaves(leaf_count(nbits)),
+	  tree(2 * nleaves, run_info{0, 0, 0}),
+	  nset(value ? nbits : 0)
+{
+	/* bits behind size() are always cleared (i.e., never free) */
+	if (value && (nbits % bpw) != 0) {
+		words.back() = range_mask(0, nbits % bpw);
+	}
+	if (value && nbits > 0) update_summary(0, nbits);
+}
+
+bitmap::size_type bitmap::size(void) const
+{
+	return nbits;
+}
+
+bitmap::size_type bitmap::count(void) const
+{
+	return nset;
+}
+
+bool bitmap::test(const size_type pos) const
+{
+	assert(pos < nbits);
+	return (words[pos / bpw] >> (pos % bpw)) & 1;
+}
+
+bool bitmap::all(const size_type pos, const size_type n) const
+{
+	assert(n > 0 && pos + n <= nbits);
+	const size_type first = pos / bpw;
+	const size_type last = (pos + n - 1) / bpw;
+	if (first == last) {
+		const word_type m = range_mask(pos % bpw, (pos + n - 1) % bpw + 1);
+		return (words[first] & m) == m;
+	}
+	const word_type mfirst = range_mask(pos % bpw, bpw);
+	if ((words[first] & mfirst) != mfirst) return false;
+	for (size_type i = first + 1; i < last; i++) {
+		if (words[i] != all_ones) return false;
+	}
+	const word_type mlast = range_mask(0, (pos + n - 1) % bpw + 1);
+	return (words[last] & mlast) == mlast;
+}
+
+void bitmap::set(const size_type pos, const size_type n)
+{
+	assert(n > 0 && pos + n <= nbits);
+	const size_type first = pos / bpw;
+	const size_type last = (pos + n - 1) / bpw;
+	/* the count changes by the bits, which were cleared before */
+	if (first == last) {
+		const word_type m = range_mask(pos % bpw, (pos + n - 1) % bpw + 1);
+		nset += popcount(m & ~words[first]);
+		words[first] |= m;
+	} else {
+		const word_type mfirst = range_mask(pos % bpw, bpw);
+		nset += popcount(mfirst & ~words[first]);
+		words[first] |= mfirst;
+		for (size_type i = first + 1; i < last; i++) {
+			nset += bpw - popcount(words[i]);
+			words[i] = all_ones;
+		}
+		const word_type mlast = range_mask(0, (pos + n - 1) % bpw + 1);
+		nset += popcount(mlast & ~words[last]);
+		words[last] |= mlast;
+	}
+	update_summary(pos, n);
+}
+
+void bitmap::reset(const size_type pos, const size_type n)
+{
+	assert(n > 0 && pos + n <= nbits);
+	const size_type first = pos / bpw;
+	const size_type last = (pos + n - 1) / bpw;
+	/* the count changes by the bits, which were set before */
+	if (first == last) {
+		const word_type m = range_mask(pos % bpw, (pos + n - 1) % bpw + 1);
+		nset -= popcount(m & words[first]);
+		words[first] &= ~m;
+	} else {
+		const word_type mfirst = range_mask(pos % bpw, bpw);
+		nset -= popcount(mfirst & words[first]);
+		words[first] &= ~mfirst;
+		for (size_type i = first + 1; i < last; i++) {
+			nset -= popcount(words[i]);
+			words[i] = 0;
+		}
+		const word_type mlast = range_mask(0, (pos + n - 1) % bpw + 1);
+		nset -= popcount(mlast & words[last]);
+		words[last] &= ~mlast;
+	}
+	update_summary(pos, n);
+}
+
+bool bitmap::try_reset(const size_type pos, const size_type n)
+{
+	if (!all(pos, n)) return false;
+	reset(pos, n);
+	return true;
+}
+
+bitmap::size_type bitmap::find_first(const size_type pos) const
+{
+	if (pos >= nbits) return nbits;
+	size_type i = pos / bpw;
+	word_type w = words[i] & (all_ones << (pos % bpw));
+	if (w == 0) {
+		/* skip the full words by the summary */
+		i = next_nonempty_word(i + 1);
+		if (i == words.size()) return nbits;
+		w = words[i];
+	}
+	return i * bpw + ctz(w);
+}
+
+bitmap::size_type bitmap::find_first_zero(const size_type pos) const
+{
+	return next_clear(pos, nbits);
+}
+
+bitmap::size_type bitmap::find_run(const size_type n, const size_type pos) const
+{
+	assert(n > 0);
+	/* reject impossible requests right away */
+	if (n > tree[1].longest || pos >= nbits) return nbits;
+	/* search the rest of the superblock of pos bit by bit.. */
+	const size_type sb = pos / bpsb;
+	size_type run_start = pos;
+	size_type run_len = 0;
+	if (scan_run(pos, std::min((sb + 1) * bpsb, nbits), n, run_start, run_len)) return run_start;
+	/*
+	 * ..and all following superblocks by the tree:
+	 * [sb+1, nleaves) is split into maximal subtrees (from left to right),
+	 * a subtree is only searched, if it contains a long enough run.
+	 */
+	size_type node = nleaves + sb + 1;
+	if (node == 2 * nleaves) return nbits;
+	for (;;) {
+		while ((node & 1) == 0 && node > 1) node >>= 1;
+		const run_info & info = tree[node];
+		const size_type len = node_bits(node);
+		if (run_len + info.prefix >= n) {
+			/* the run continued from the left is long enough */
+			if (run_len == 0) run_start = node_start(node);
+			return run_start;
+		}
+		if (info.longest >= n) {
+			return find_run_in_node(node, n);
+		}
+		if (info.prefix == len) {
+			if (run_len == 0) run_start = node_start(node);
+			run_len += len;
+		} else {
+			run_len = info.suffix;
+			run_start = node_start(node) + len - info.suffix;
+		}
+		node++;
+		/* node is the first one of the next level: all subtrees processed */
+		if ((node & (node - 1)) == 0) break;
+	}
+	return nbits;
+}
+
+bitmap::size_type bitmap::longest_run(void) const
+{
+	return tree[1].longest;
+}
+
+bool bitmap::operator ==(const bitmap & b) const
+{
+	return nbits == b.nbits && words == b.words;
+}
+
+std::ostream & operator <<(std::ostream & os, const bitmap & b)
+{
+	for (size_type i = b.size(); i > 0; i--) {
+		os << (b.test(i - 1) ? '1' : '0');
+	}
+	return os;
+}
+
+bitmap::size_type bitmap::next_set(const size_type pos, const size_type end) const
+{
+	if (pos >= end) return end;
+	size_type i = pos / bpw;
+	word_type w = words[i] & (all_ones << (pos % bpw));
+	const size_type iend = word_count(end);
+	while (w == 0) {
+		if (++i == iend) return end;
+		w = words[i];
+	}
+	return std::min(i * bpw + ctz(w), end);
+}
+
+bitmap::size_type bitmap::next_clear(const size_type pos, const size_type end) const
+{
+	if (pos >= end) return end;
+	size_type i = pos / bpw;
+	word_type w = ~words[i] & (all_ones << (pos % bpw));
+	const size_type iend = word_count(end);
+	while (w == 0) {
+		if (++i == iend) return end;
+		w = ~words[i];
+	}
+	/* the (cleared) bits behind size() terminate the last run */
+	return std::min(i * bpw + ctz(w), end);
+}
+
+bitmap::size_type bitmap::next_nonempty_word(const size_type i) const
+{
+	if (i >= words.size()) return words.size();
+	size_type j = i / bpw;
+	word_type s = nonempty[j] & (all_ones << (i % bpw));
+	while (s == 0) {
+		if (++j == nonempty.size()) return words.size();
+		s = nonempty[j];
+	}
+	return std::min(j * bpw + ctz(s), words.size());
+}
+
+/*
+ * Continues the search of a run of n set bits in [lo, hi),
+ * where [run_start, run_start+run_len) is a run of set bits ending at lo.
+ * Returns true, if [run_start, run_start+run_len) is long enough.
+ */
+bool bitmap::scan_run(const size_type lo, const size_type hi, const size_type n,
+                      size_type & run_start, size_type & run_len) const
+{
+	size_type pos = lo;
+	while (pos < hi) {
+		if (!test(pos)) {
+			run_len = 0;
+			pos = next_set(pos, hi);
+			continue;
+		}
+		const size_type end = next_clear(pos, hi);
+		if (run_len == 0) run_start = pos;
+		run_len += end - pos;
+		if (run_len >= n) return true;
+		pos = end;
+	}
+	return false;
+}
+
+/* returns the first run of n set bits completely inside the subtree of node */
+bitmap::size_type bitmap::find_run_in_node(size_type node, const size_type n) const
+{
+	assert(tree[node].longest >= n);
+	while (node < nleaves) {
+		const run_info & left = tree[2 * node];
+		const run_info & right = tree[2 * node + 1];
+		if (left.longest >= n) {
+			node = 2 * node;
+		} else if (left.suffix + right.prefix >= n) {
+			return node_start(2 * node + 1) - left.suffix;
+		} else {
+			node = 2 * node + 1;
+		}
+	}
+	const size_type lo = node_start(node);
+	size_type run_start = lo;
+	size_type run_len = 0;
+	const bool found = scan_run(lo, std::min(lo + bpsb, nbits), n, run_start, run_len);
+	assert(found);
+	(void)found;
+	return run_start;
+}
+
+bitmap::size_type bitmap::node_bits(const size_type node) const
+{
+	return (nleaves / level_start(node)) * bpsb;
+}
+
+bitmap::size_type bitmap::node_start(const size_type node) const
+{
+	const size_type first = level_start(node);
+	return (node - first) * node_bits(node);
+}
+
+bitmap::run_info bitmap::summarize_superblock(const size_type sb) const
+{
+	run_info info{0, 0, 0};
+	const size_type lo = sb * bpsb;
+	if (lo >= nbits) return info;
+	const size_type hi = std::min(lo + bpsb, nbits);
+	size_type pos = next_set(lo, hi);
+	info.prefix = (pos == lo) ? next_clear(lo, hi) - lo : 0;
+	while (pos < hi) {
+		const size_type end = next_clear(pos, hi);
+		info.longest = std::max(info.longest, end - pos);
+		/* a run at the end of the bitmap is not continued by the (missing) next superblock */
+		if (end == lo + bpsb) info.suffix = end - pos;
+		pos = next_set(end, hi);
+	}
+	return info;
+}
+
+void bitmap::update_summary(const size_type pos, const size_type n)
+{
+	assert(n > 0 && pos + n <= nbits);
+	/* level 1: one bit per word */
+	const size_type wfirst = pos / bpw;
+	const size_type wlast = (pos + n - 1) / bpw;
+	for (size_type i = wfirst; i <= wlast; i++) {
+		const word_type bit = static_cast<word_type>(1) << (i % bpw);
+		if (words[i] != 0) {
+			nonempty[i / bpw] |= bit;
+		} else {
+			nonempty[i / bpw] &= ~bit;
+		}
+	}
+	/* level 2: the superblocks and all their ancestors in the tree */
+	size_type lo = nleaves + pos / bpsb;
+	size_type hi = nleaves + (pos + n - 1) / bpsb;
+	for (size_type i = lo; i <= hi; i++) {
+		tree[i] = summarize_superblock(i - nleaves);
+	}
+	size_type len = bpsb;
+	while (lo > 1) {
+		lo >>= 1;
+		hi >>= 1;
+		for (size_type i = lo; i <= hi; i++) {
+			const run_info & a = tree[2 * i];
+			const run_info & b = tree[2 * i + 1];
+			run_info & r = tree[i];
+			r.prefix = (a.prefix == len) ? len + b.prefix : a.prefix;
+			r.suffix = (b.suffix == len) ? len + a.suffix : b.suffix;
+			r.longest = std::max(std::max(a.longest, b.longest), a.suffix + b.prefix);
+		}
+		len <<= 1;
+	}
+}
+
+} /* namespace StaticMemoryAllocator */
@@ -0,0 +1,163 @@
+#ifndef STATIC_MEMORY_ALLOCATOR__BITMAP_H__AD_
+#define STATIC_MEMORY_ALLOCATOR__BITMAP_H__AD_
+
+/**
+ * \file StaticMemoryAllocator\bitmap.hpp
+ * \author Angelos Drossos <angelos.drossos@gmail.com>
+ */
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <ostream>
+
+namespace StaticMemoryAllocator {
+
+/**
+ * Bitmap of the free memory of an allocator (one bit per managed byte,
+ * a set bit means free, a cleared bit means reserved).
+ *
+ * The bits are stored in 64-bit words, thus searching for free memory
+ * and reserving or freeing memory works on whole words
+ * (using count-trailing-zeros and popcount) instead of single bits.
+ * Updates only touch the words covering the changed range.
+ *
+ * On top of the bits, two summary levels are kept up to date:
+ * one bit per word telling whether the word has any set bit,
+ * and a tree over superblocks (of 64 words each) storing the free run
+ * at the beginning and at the end of a region and its longest free run.
+ * Searching skips full words and whole regions without a long enough run,
+ * and the longest run of the whole bitmap is known without any scan.
+ */
+class bitmap
+{
+public:
+	typedef uint64_t    word_type;
+	typedef std::size_t size_type;
+
+	static const size_type bits_per_word = 64;
+	static const size_type bits_per_superblock = 64 * bits_per_word;
+
+/* constructors, destructors, assignment operators */
+public:
+
+	bitmap() = delete;
+
+	/**
+	 * Constructs a bitmap of \p nbits bits, all set to \p value.
+	 */
+	explicit bitmap(const size_type nbits, const bool value = false);
+
+/* bitmap functions */
+public:
+
+	size_type size(void) const;
+
+	/**
+	 * Returns the number of set bits (kept up to date by each update).
+	 */
+	size_type count(void) const;
+
+	bool test(const size_type pos) const;
+
+	/**
+	 * Returns true, if all bits in [pos, pos+n) are set.
+	 */
+	bool all(const size_type pos, const size_type n) const;
+
+	/**
+	 * Sets all bits in [pos, pos+n).
+	 */
+	void set(const size_type pos, const size_type n);
+
+	/**
+	 * Clears all bits in [pos, pos+n).
+	 */
+	void reset(const size_type pos, const size_type n);
+
+	/**
+	 * Clears all bits in [pos, pos+n), if all of them are set.
+	 *
+	 * \return false (and nothing changed), if one of the bits was not set.
+	 */
+	bool try_reset(const size_type pos, const size_type n);
+
+	/**
+	 * Returns the position of the first set bit in [pos, size()),
+	 * or size() if there is none.
+	 */
+	size_type find_first(const size_type pos) const;
+
+	/**
+	 * Returns the position of the first cleared bit in [pos, size()),
+	 * or size() if there is none.
+	 */
+	size_type find_first_zero(const size_type pos) const;
+
+	/**
+	 * Returns the position of the first run of (at least) \p n set bits
+	 * starting at or after \p pos, or size() if there is none.
+	 */
+	size_type find_run(const size_type n, const size_type pos = 0) const;
+
+	/**
+	 * Returns the length of the longest run of set bits (from the summary).
+	 */
+	size_type longest_run(void) const;
+
+	bool operator ==(const bitmap & b) const;
+
+	/**
+	 * Prints the bitmap, the highest bit first (as boost::dynamic_bitset does).
+	 */
+	friend std::ostream & operator <<(std::ostream & os, const bitmap & b);
+
+private:
+
+	/**
+	 * Summary of a region: the lengths of the run of set bits
+	 * at its beginning and at its end, and of its longest run.
+	 */
+	struct run_info
+	{
+		size_type prefix;
+		size_type suffix;
+		size_type longest;
+	};
+
+	size_type next_set(const size_type pos, const size_type end) const;
+
+	size_type next_clear(const size_type pos, const size_type end) const;
+
+	size_type next_nonempty_word(const size_type i) const;
+
+	bool scan_run(const size_type lo, const size_type hi, const size_type n,
+	              size_type & run_start, size_type & run_len) const;
+
+	size_type find_run_in_node(const size_type node, const size_type n) const;
+
+	size_type node_bits(const size_type node) const;
+
+	size_type node_start(const size_type node) const;
+
+	run_info summarize_superblock(const size_type sb) const;
+
+	void update_summary(const size_type pos, const size_type n);
+
+/* member variables */
+private:
+
+	size_type nbits;
+	std::vector<word_type> words;
+	/* one bit per word: set, if the word has any set bit */
+	std::vector<word_type> nonempty;
+	/* number of leaves of the tree (a power of two) */
+	size_type nleaves;
+	/* summary tree over the superblocks, the root at index 1, the leaves at [nleaves, 2*nleaves) */
+	std::vector<run_info> tree;
+	/* number of set bits */
+	size_type nset;
+};
+
+} /* namespace StaticMemoryAllocator */
+#endif /* STATIC_MEMORY_ALLOCATOR__BITMAP_H__AD_ */
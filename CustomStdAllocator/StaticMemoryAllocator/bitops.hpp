@@ -0,0 +1,124 @@
+#ifndef STATIC_MEMORY_ALLOCATOR__BITOPS_H__AD_
+#define STATIC_MEMORY_ALLOCATOR__BITOPS_H__AD_
+
+/**
+ * \file StaticMemoryAllocator\bitops.hpp
+ * \author Angelos Drossos <angelos.drossos@gmail.com>
+ *
+ * Operations on 64-bit words, shared by the bitmaps.
+ */
+
+#include <cstdint>
+#include <cstddef>
+
+#include <assert.h>
+
+namespace StaticMemoryAllocator {
+namespace bitops {
+
+typedef uint64_t    word_type;
+typedef std::size_t size_type;
+
+static const size_type bits_per_word = 64;
+static const word_type all_ones = ~static_cast<word_type>(0);
+
+/**
+ * Returns the number of trailing zero bits of \p w (which must not be 0).
+ */
+inline size_type ctz(const word_type w)
+{
+	assert(w != 0);
+#	if defined(__GNUC__)
+	return static_cast<size_type>(__builtin_ctzll(w));
+#	else
+	size_type n = 0;
+	while (!((w >> n) & 1)) n++;
+	return n;
+#	endif
+}
+
+/**
+ * Returns the index of the highest set bit of \p w (which must not be 0).
+ */
+inline size_type msb(const word_type w)
+{
+	assert(w != 0);
+#	if defined(__GNUC__)
+	return static_cast<size_type>(63 - __builtin_clzll(w));
+#	else
+	size_type n = 63;
+	while (!((w >> n) & 1)) n--;
+	return n;
+#	endif
+}
+
+/**
+ * Returns the number of set bits of \p w.
+ */
+inline size_type popcount(const word_type w)
+{
+#	if defined(__GNUC__)
+	return static_cast<size_type>(__builtin_popcountll(w));
+#	else
+	size_type n = 0;
+	for (word_type v = w; v != 0; v &= v - 1) n++;
+	return n;
+#	endif
+}
+
+/**
+ * Returns the mask of the bits [lo, hi) of a word, with lo < hi <= bits_per_word.
+ */
+inline word_type range_mask(const size_type lo, const size_type hi)
+{
+	assert(lo < hi && hi <= bits_per_word);
+	const word_type upper = (hi == bits_per_word) ? all_ones : ((static_cast<word_type>(1) << hi) - 1);
+	return upper & (all_ones << lo);
+}
+
+/**
+ * Returns the number of words needed for \p nbits bits.
+ */
+inline size_type word_count(const size_type nbits)
+{
+	return (nbits + bits_per_word - 1) / bits_per_word;
+}
+
+/**
+ * Sets (\p value) or clears (!\p value) the bits [pos, pos+n) of the words \p w.
+ */
+inline void assign(word_type *const w, const size_type pos, const size_type n, const bool value)
+{
+	size_type i = pos;
+	const size_type last = pos + n;
+	while (i < last) {
+		const size_type lo = i % bits_per_word;
+		const size_type hi = (last - i + lo < bits_per_word) ? last - i + lo : bits_per_word;
+		const word_type mask = range_mask(lo, hi);
+		word_type & wi = w[i / bits_per_word];
+		wi = value ? (wi | mask) : (wi & ~mask);
+		i += hi - lo;
+	}
+}
+
+/**
+ * Returns the first set (\p value) or cleared (!\p value) bit in [pos, nbits)
+ * of the \p nbits bits of the words \p w, or nbits if there is none.
+ */
+inline size_type find(const word_type *const w, const size_type nbits, const size_type pos, const bool value)
+{
+	if (pos >= nbits) return nbits;
+	const size_type nwords = word_count(nbits);
+	size_type i = pos / bits_per_word;
+	word_type wi = (value ? w[i] : ~w[i]) & (all_ones << (pos % bits_per_word));
+	while (wi == 0) {
+		if (++i == nwords) return nbits;
+		wi = value ? w[i] : ~w[i];
+	}
+	const size_type found = i * bits_per_word + ctz(wi);
+	return (found < nbits) ? found : nbits;
+}
+
+} /* namespace bitops */
+} /* namespace StaticMemoryAllocator */
+#endif /* STATIC_MEMORY_ALLOCATOR__BITOPS_H__AD_ */
@@ -0,0 +1,224 @@
+/**
+ * \file StaticMemoryAllocator\buddy_arena.cpp
+ * \author Angelos Drossos <angelos.drossos@gmail.com>
+ */
+#include "buddy_arena.hpp"
+#include "bitops.hpp"
+
+#include <algorithm>
+#include <iostream>
+
+#include <assert.h>
+
+namespace StaticMemoryAllocator {
+
+namespace {
+
+using bitops::ctz;
+using bitops::msb;
+using bitops::all_ones;
+
+typedef buddy_arena::size_type size_type;
+
+const uint8_t free_flag = 0x80;
+
+inline uintptr_t align_up(const uintptr_t addr, const size_type alignment)
+{
+	return (addr + alignment - 1) & ~static_cast<uintptr_t>(alignment - 1);
+}
+
+inline size_type block_bytes(const size_type order)
+{
+	return static_cast<size_type>(1) << order;
+}
+
+} /* anonymous namespace */
+
+const buddy_arena::size_type buddy_arena::granule_size;
+
+buddy_arena::buddy_arena(void *const memstart, const size_type memsize, const std::string & memname)
+	: start(reinterpret_cast<byte *>(align_up(reinterpret_cast<uintptr_t>(memstart), granule_size))),
+	  end(reinterpret_cast<byte *>((reinterpret_cast<uintptr_t>(memstart) + memsize) & ~static_cast<uintptr_t>(granule_size - 1))),
+	  memname(memname),
+	  orders((end > start) ? static_cast<size_type>(end - start) / granule_size : 0, 0),
+	  order_bitmap(0)
+{
+	assert(memstart != nullptr);
+	assert(end > start);
+	std::fill(free_lists, free_lists + order_count, nullptr);
+	/* split the memory block into the largest blocks, which are aligned to their size */
+	for (byte *b = start; b < end; ) {
+		const uintptr_t addr = reinterpret_cast<uintptr_t>(b);
+		size_type order = std::min<size_type>(ctz(addr), msb(static_cast<size_type>(end - b)));
+		assert(order >= min_order);
+		insert_free(b, order);
+		b += block_bytes(order);
+	}
+}
+
+void *buddy_arena::allocate(const size_type nb, const size_type alignment, void *const hint)
+{
+	assert(nb > 0);
+	assert(alignment > 0 && (alignment & (alignment - 1)) == 0);
+	(void) hint;
+	if (nb > size() || alignment > size()) return nullptr;
+	/* each block is aligned to its size */
+	const size_type order = calc_order(std::max(nb, alignment));
+	const uint64_t candidates = order_bitmap & (all_ones << order);
+	if (candidates == 0) return nullptr;
+	size_type k = ctz(candidates);
+	byte *const b = reinterpret_cast<byte *>(free_lists[k]);
+	remove_free(b, k);
+	/* the upper halves of the split block stay free */
+	while (k > order) {
+		k--;
+		insert_free(b + block_bytes(k), k);
+	}
+	orders[calc_pos(b)] = static_cast<uint8_t>(order);
+	return b;
+}
+
+void buddy_arena::deallocate(void *const p, const size_type nb)
+{
+	assert(p != nullptr);
+	byte *b = static_cast<byte *>(p);
+	size_type order = orders[calc_pos(b)];
+	assert(order >= min_order && (order & free_flag) == 0);
+	assert(nb <= block_bytes(order));
+	(void) nb;
+	orders[calc_pos(b)] = 0;
+	for (; order + 1 < order_count; order++) {
+		const uintptr_t addr = reinterpret_cast<uintptr_t>(b);
+		byte *const buddy = reinterpret_cast<byte *>(addr ^ block_bytes(order));
+		/* a buddy outside of the memory block is never free */
+		if (buddy < start || buddy + block_bytes(order) > end) break;
+		if (orders[calc_pos(buddy)] != (order | free_flag)) break;
+		remove_free(buddy, order);
+		b = std::min(b, buddy);
+	}
+	insert_free(b, order);
+}
+
+bool buddy_arena::expand(void *const p, const size_type old_nb, const size_type new_nb)
+{
+	assert(old_nb > 0 && new_nb > 0);
+	(void) old_nb;
+	if (new_nb > size()) return false;
+	byte *const b = static_cast<byte *>(p);
+	const size_type order = orders[calc_pos(b)];
+	assert(order >= min_order && (order & free_flag) == 0);
+	const size_type new_order = calc_order(new_nb);
+	if (new_order <= order) return true;
+	/* the block has to be the first half of each larger block, and the second halves have to be free */
+	const uintptr_t addr = reinterpret_cast<uintptr_t>(b);
+	for (size_type k = order; k < new_order; k++) {
+		byte *const buddy = b + block_bytes(k);
+		if ((addr & block_bytes(k)) != 0) return false;
+		if (buddy + block_bytes(k) > end) return false;
+		if (orders[calc_pos(buddy)] != (k | free_flag)) return false;
+	}
+	for (size_type k = order; k < new_order; k++) {
+		remove_free(b + block_bytes(k), k);
+	}
+	orders[calc_pos(b)] = static_cast<uint8_t>(new_order);
+	return true;
+}
+
+bool buddy_arena::shrink(void *const p, const size_type old_nb, const size_type new_nb)
+{
+	assert(old_nb > 0 && new_nb > 0);
+	(void) old_nb;
+	byte *const b = static_cast<byte *>(p);
+	size_type order = orders[calc_pos(b)];
+	assert(order >= min_order && (order & free_flag) == 0);
+	const size_type new_order = calc_order(new_nb);
+	/* the second halves are free, their buddies (the first halves) are used */
+	while (order > new_order) {
+		order--;
+		insert_free(b + block_bytes(order), order);
+	}
+	orders[calc_pos(b)] = static_cast<uint8_t>(order);
+	return true;
+}
+
+buddy_arena::size_type buddy_arena::max_size(void) const
+{
+	return (order_bitmap != 0) ? block_bytes(msb(order_bitmap)) : 0;
+}
+
+buddy_arena::size_type buddy_arena::size(void) const
+{
+	return static_cast<size_type>(end - start);
+}
+
+void *const buddy_arena::memstart(void) const
+{
+	return start;
+}
+
+void *const buddy_arena::memend(void) const
+{
+	return end;
+}
+
+const std::string & buddy_arena::name(void) const
+{
+	return memname;
+}
+
+bool buddy_arena::operator ==(const buddy_arena & a) const
+{
+	return this == &a;
+}
+
+void buddy_arena::print_free_memory(void) const
+{
+	std::cout << "free memory (" << ((memname.empty()) ? "<unnamed>" : memname) << "):";
+	for (size_type k = min_order; k < order_count; k++) {
+		size_type n = 0;
+		for (const free_block *f = free_lists[k]; f != nullptr; f = f->next) n++;
+		if (n > 0) std::cout << " " << n << "x" << block_bytes(k);
+	}
+	std::cout << " at [" << static_cast<void *>(start) << ", " << static_cast<void *>(end) << ")" << std::endl;
+}
+
+buddy_arena::size_type buddy_arena::calc_order(const size_type nb)
+{
+	if (nb <= block_bytes(min_order)) return min_order;
+	return msb(nb - 1) + 1;
+}
+
+buddy_arena::size_type buddy_arena::calc_pos(const byte *const b) const
+{
+	assert(b >= start && b < end);
+	assert((b - start) % granule_size == 0);
+	return static_cast<size_type>(b - start) / granule_size;
+}
+
+void buddy_arena::insert_free(byte *const b, const size_type order)
+{
+	free_block *const f = reinterpret_cast<free_block *>(b);
+	f->next = free_lists[order];
+	f->prev = nullptr;
+	if (f->next != nullptr) f->next->prev = f;
+	free_lists[order] = f;
+	order_bitmap |= static_cast<uint64_t>(1) << order;
+	orders[calc_pos(b)] = static_cast<uint8_t>(order | free_flag);
+}
+
+void buddy_arena::remove_free(byte *const b, const size_type order)
+{
+	assert(orders[calc_pos(b)] == (order | free_flag));
+	free_block *const f = reinterpret_cast<free_block *>(b);
+	if (f->next != nullptr) f->next->prev = f->prev;
+	if (f->prev != nullptr) {
+		f->prev->next = f->next;
+	} else {
+		assert(free_lists[order] == f);
+		free_lists[order] = f->next;
+		if (f->next == nullptr) order_bitmap &= ~(static_cast<uint64_t>(1) << order);
+	}
+	orders[calc_pos(b)] = 0;
+}
+
+} /* namespace StaticMemoryAllocator */
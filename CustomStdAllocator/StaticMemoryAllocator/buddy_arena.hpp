@@ -0,0 +1,142 @@
+#ifndef STATIC_MEMORY_ALLOCATOR__BUDDY_ARENA_H__AD_
+#define STATIC_MEMORY_ALLOCATOR__BUDDY_ARENA_H__AD_
+
+/**
+ * \file StaticMemoryAllocator\buddy_arena.hpp
+ * \author Angelos Drossos <angelos.drossos@gmail.com>
+ */
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace StaticMemoryAllocator {
+
+/**
+ * Manages a static memory block [memstart, memend()) by a buddy system.
+ *
+ * Each block has a size of a power of two (its order) and is aligned
+ * to its size. A block of order k is split into two buddies of order
+ * k - 1 if a smaller block is needed, and a freed block is merged with
+ * its buddy as long as the buddy is free, too. Thus allocating and
+ * freeing take O(log n) steps, without searching for free memory.
+ * Requests are rounded up to a power of two, which suits growing
+ * vectors and power-of-two buffers (other sizes waste up to half
+ * of their block).
+ *
+ * The memory block is split into the largest aligned blocks fitting
+ * into it. The free lists are stored inside the free blocks, the order
+ * of each block is kept in one byte per granule (outside of the managed
+ * memory block). The arena must not be used by several threads at the
+ * same time.
+ */
+class buddy_arena
+{
+public:
+	typedef std::size_t        size_type;
+
+	static const size_type granule_size = 16;
+
+/* constructors, destructors, assignment operators */
+public:
+
+	buddy_arena() = delete;
+
+	buddy_arena(void *const memstart, const size_type memsize, const std::string & memname = "");
+
+	buddy_arena(const buddy_arena & a) = delete;
+
+	buddy_arena & operator =(const buddy_arena & a) = delete;
+
+/* arena functions */
+public:
+
+	/**
+	 * Reserves a memory block of (at least) \p nb bytes.
+	 *
+	 * \param nb Size of the memory block in bytes (rounded up to a power of two).
+	 * \param alignment Alignment of the memory block (a power of two).
+	 * \param hint Not used.
+	 * \return Pointer to the memory block, or nullptr if there is no
+	 *         large enough free memory block.
+	 */
+	void *allocate(const size_type nb, const size_type alignment, void *const hint = nullptr);
+
+	/**
+	 * Frees the memory block at \p p (which was reserved by allocate()).
+	 */
+	void deallocate(void *const p, const size_type nb);
+
+	/**
+	 * Grows the memory block at \p p to \p new_nb bytes: within its order,
+	 * or by merging it with its free buddies, if it is the first half of them.
+	 *
+	 * \return false (and nothing changed), if the block cannot grow in place.
+	 */
+	bool expand(void *const p, const size_type old_nb, const size_type new_nb);
+
+	/**
+	 * Shrinks the memory block at \p p to \p new_nb bytes
+	 * (the unused halves of the block are freed).
+	 */
+	bool shrink(void *const p, const size_type old_nb, const size_type new_nb);
+
+	/**
+	 * Returns the size of the largest free memory block in bytes.
+	 */
+	size_type max_size(void) const;
+
+	size_type size(void) const;
+
+	void *const memstart(void) const;
+
+	void *const memend(void) const;
+
+	const std::string & name(void) const;
+
+	bool operator ==(const buddy_arena & a) const;
+
+	void print_free_memory(void) const;
+
+private:
+
+	typedef uint8_t byte;
+
+	static const size_type min_order = 4;
+	static const size_type order_count = 64;
+
+	/* links of the free list, stored in a free block */
+	struct free_block
+	{
+		free_block *next;
+		free_block *prev;
+	};
+
+	static
+	size_type calc_order(const size_type nb);
+
+	size_type calc_pos(const byte *const b) const;
+
+	void insert_free(byte *const b, const size_type order);
+
+	void remove_free(byte *const b, const size_type order);
+
+/* member variables */
+private:
+
+	byte *start;
+	byte *end;
+	std::string memname;
+	/*
+	 * per granule: 0, if no block starts at the granule,
+	 * otherwise the order of the block (and free_flag, if it is free)
+	 */
+	std::vector<uint8_t> orders;
+	/* bit k is set, if there is a free block of order k */
+	uint64_t order_bitmap;
+	free_block *free_lists[order_count];
+};
+
+} /* namespace StaticMemoryAllocator */
+#endif /* STATIC_MEMORY_ALLOCATOR__BUDDY_ARENA_H__AD_ */
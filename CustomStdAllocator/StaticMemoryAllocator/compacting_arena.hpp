@@ -0,0 +1,213 @@
+#ifndef STATIC_MEMORY_ALLOCATOR__COMPACTING_ARENA_H__AD_
+#define STATIC_MEMORY_ALLOCATOR__COMPACTING_ARENA_H__AD_
+
+/**
+ * \file StaticMemoryAllocator\compacting_arena.hpp
+ * \author Angelos Drossos <angelos.drossos@gmail.com>
+ */
+
+#include "bitmap.hpp"
+
+#include <cstdint>
+#include <cstddef>
+#include <deque>
+#include <vector>
+#include <string>
+#include <type_traits>
+
+namespace StaticMemoryAllocator {
+
+/**
+ * Entry of the handle table of a compacting_arena:
+ * the current location and the size of a memory block.
+ */
+struct handle_slot
+{
+	void *block;
+	std::size_t nb;
+};
+
+/**
+ * Handle of a memory block of a compacting_arena, which stays valid
+ * while the block is moved by compact().
+ *
+ * The handle points to the entry of the block in the handle table,
+ * thus resolving it costs one indirection. A pointer returned by get()
+ * is only valid until the next compact().
+ *
+ * \tparam T Value type.
+ */
+template <class T>
+class handle
+{
+public:
+	typedef T                  value_type;
+	typedef value_type       * pointer;
+	typedef value_type       & reference;
+
+/* constructors, destructors, assignment operators */
+public:
+
+	/**
+	 * Constructs an empty handle.
+	 */
+	handle() : slot(nullptr) {}
+
+	explicit handle(handle_slot *const s) : slot(s) {}
+
+/* handle functions */
+public:
+
+	/**
+	 * Returns the current location of the memory block.
+	 */
+	pointer get(void) const { return static_cast<pointer>(slot->block); }
+
+	reference operator *(void) const { return *get(); }
+
+	pointer operator ->(void) const { return get(); }
+
+	reference operator [](const std::size_t i) const { return get()[i]; }
+
+	explicit operator bool(void) const { return slot != nullptr; }
+
+	bool operator ==(const handle & h) const { return slot == h.slot; }
+
+	bool operator !=(const handle & h) const { return slot != h.slot; }
+
+	handle_slot *get_slot(void) const { return slot; }
+
+/* member variables */
+private:
+
+	handle_slot *slot;
+};
+
+/**
+ * Arena, which hands out handles instead of pointers, thus it can move
+ * the memory blocks: compact() slides all memory blocks to the beginning
+ * of the managed memory block (keeping their order) and updates their
+ * handles, thus all free memory becomes one run at the end again.
+ *
+ * This is for long running processes, whose memory fragments until
+ * a large memory block cannot be allocated anymore, although there is
+ * enough free memory in total (see available() and max_size()).
+ *
+ * The memory blocks are moved by memmove, thus only trivially copyable
+ * types can be allocated. The arena must not be used by several threads
+ * at the same time.
+ *
+ * \tparam Granule Size of a granule in bytes (a power of two),
+ *         all memory blocks are aligned to it.
+ */
+template <std::size_t Granule = 16>
+class compacting_arena
+{
+	static_assert(Granule > 0 && (Granule & (Granule - 1)) == 0,
+	              "the granule size has to be a power of two");
+
+public:
+	typedef std::size_t        size_type;
+	typedef bitmap             bitmap_type;
+
+	static const size_type granule_size = Granule;
+
+/* constructors, destructors, assignment operators */
+public:
+
+	compacting_arena() = delete;
+
+	compacting_arena(void *const memstart, const size_type memsize, const std::string & memname = "");
+
+	compacting_arena(const compacting_arena & a) = delete;
+
+	compacting_arena & operator =(const compacting_arena & a) = delete;
+
+/* arena functions */
+public:
+
+	/**
+	 * Reserves a memory block for \p n objects of type T (which are not constructed).
+	 *
+	 * \return Handle of the memory block, or an empty handle if there is
+	 *         no large enough free memory block (compact() may help,
+	 *         if available() is large enough).
+	 */
+	template <class T>
+	handle<T> allocate(const size_type n);
+
+	/**
+	 * Frees the memory block of \p h (which was reserved by allocate())
+	 * and its entry in the handle table.
+	 */
+	template <class T>
+	void deallocate(const handle<T> h);
+
+	/**
+	 * Moves all memory blocks to the beginning of the managed memory block
+	 * and updates their handles (pointers resolved before are invalid afterwards).
+	 *
+	 * \return Number of bytes moved.
+	 */
+	size_type compact(void);
+
+	/**
+	 * Returns the size of the largest free memory block in bytes.
+	 */
+	size_type max_size(void) const;
+
+	/**
+	 * Returns the number of free bytes (the size of the largest
+	 * free memory block after compact()).
+	 */
+	size_type available(void) const;
+
+	/**
+	 * Returns the number of allocated memory blocks.
+	 */
+	size_type handles(void) const;
+
+	size_type size(void) const;
+
+	void *const memstart(void) const;
+
+	void *const memend(void) const;
+
+	const std::string & name(void) const;
+
+	void print_free_memory(void) const;
+
+private:
+
+	typedef uint8_t byte;
+
+	void *allocate_block(const size_type nb);
+
+	void deallocate_block(handle_slot *const s);
+
+	void *calc_pointer(const size_type pos) const;
+
+	size_type calc_pos(const void *const p) const;
+
+	static
+	byte *align_start(void *const memstart);
+
+	static
+	size_type calc_memsize(void *const memstart, const size_type memsize);
+
+	static
+	size_type calc_granules(const size_type nb);
+
+/* member variables */
+private:
+
+	byte *start;
+	bitmap_type memfree;
+	/* the handle table: a deque keeps the entries in place when it grows */
+	std::deque<handle_slot> slots;
+	std::vector<handle_slot *> free_slots;
+	std::string memname;
+};
+
+} /* namespace StaticMemoryAllocator */
+#endif /* STATIC_MEMORY_ALLOCATOR__COMPACTING_ARENA_H__AD_ */
@@ -0,0 +1,194 @@
+#ifndef STATIC_MEMORY_ALLOCATOR__COMPACTING_ARENA_IMPL_H__AD_
+#define STATIC_MEMORY_ALLOCATOR__COMPACTING_ARENA_IMPL_H__AD_
+
+#include "compacting_arena.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+#include <assert.h>
+
+namespace StaticMemoryAllocator {
+
+template <std::size_t Granule>
+compacting_arena<Granule>::compacting_arena(void *const memstart, const size_type memsize, const std::string & memname)
+	: start(align_start(memstart)),
+	  memfree(calc_memsize(memstart, memsize), true),
+	  memname(memname)
+{
+	assert(memstart != nullptr);
+	assert(memfree.size() > 0);
+}
+
+template <std::size_t Granule>
+template <class T>
+handle<T> compacting_arena<Granule>::allocate(const size_type n)
+{
+	static_assert(std::is_trivially_copyable<T>::value,
+	              "the memory blocks are moved by memmove");
+	static_assert(alignof(T) <= Granule,
+	              "the memory blocks are only aligned to the granule size");
+	assert(n > 0);
+	void *const p = allocate_block(n * sizeof(T));
+	if (p == nullptr) return handle<T>();
+	handle_slot *s;
+	if (!free_slots.empty()) {
+		s = free_slots.back();
+		free_slots.pop_back();
+	} else {
+		slots.push_back(handle_slot{nullptr, 0});
+		s = &slots.back();
+	}
+	s->block = p;
+	s->nb = n * sizeof(T);
+	return handle<T>(s);
+}
+
+template <std::size_t Granule>
+template <class T>
+void compacting_arena<Granule>::deallocate(const handle<T> h)
+{
+	assert(h);
+	deallocate_block(h.get_slot());
+}
+
+template <std::size_t Granule>
+typename compacting_arena<Granule>::size_type compacting_arena<Granule>::compact(void)
+{
+	/* the memory blocks in the order of their locations */
+	std::vector<handle_slot *> live;
+	live.reserve(slots.size() - free_slots.size());
+	for (auto & s : slots) {
+		if (s.block != nullptr) live.push_back(&s);
+	}
+	std::sort(live.begin(), live.end(), [](const handle_slot *a, const handle_slot *b) {
+		return a->block < b->block;
+	});
+	/* slide each memory block down to the end of the ones before it */
+	size_type top = 0;
+	size_type moved = 0;
+	for (handle_slot *const s : live) {
+		const size_type ng = calc_granules(s->nb);
+		void *const dest = calc_pointer(top);
+		if (s->block != dest) {
+			std::memmove(dest, s->block, s->nb);
+			s->block = dest;
+			moved += s->nb;
+		}
+		top += ng;
+	}
+	/* [0, top) is reserved, the rest is one free run */
+	if (top > 0) memfree.reset(0, top);
+	if (top < memfree.size()) memfree.set(top, memfree.size() - top);
+	return moved;
+}
+
+template <std::size_t Granule>
+typename compacting_arena<Granule>::size_type compacting_arena<Granule>::max_size(void) const
+{
+	return memfree.longest_run() * Granule;
+}
+
+template <std::size_t Granule>
+typename compacting_arena<Granule>::size_type compacting_arena<Granule>::available(void) const
+{
+	return memfree.count() * Granule;
+}
+
+template <std::size_t Granule>
+typename compacting_arena<Granule>::size_type compacting_arena<Granule>::handles(void) const
+{
+	return slots.size() - free_slots.size();
+}
+
+template <std::size_t Granule>
+typename compacting_arena<Granule>::size_type compacting_arena<Granule>::size(void) const
+{
+	return memfree.size() * Granule;
+}
+
+template <std::size_t Granule>
+void *const compacting_arena<Granule>::memstart(void) const
+{
+	return start;
+}
+
+template <std::size_t Granule>
+void *const compacting_arena<Granule>::memend(void) const
+{
+	return start + size();
+}
+
+template <std::size_t Granule>
+const std::string & compacting_arena<Granule>::name(void) const
+{
+	return memname;
+}
+
+template <std::size_t Granule>
+void compacting_arena<Granule>::print_free_memory(void) const
+{
+	std::cout << "free memory (" << ((memname.empty()) ? "<unnamed>" : memname) << "): "
+		  << available() << " of " << size() << " bytes, largest block " << max_size() << " bytes, "
+		  << handles() << " handles" << std::endl;
+}
+
+template <std::size_t Granule>
+void *compacting_arena<Granule>::allocate_block(const size_type nb)
+{
+	const size_type ng = calc_granules(nb);
+	if (ng > memfree.count()) return nullptr;
+	const size_type pos = memfree.find_run(ng);
+	if (!(pos < memfree.size())) return nullptr;
+	memfree.reset(pos, ng);
+	return calc_pointer(pos);
+}
+
+template <std::size_t Granule>
+void compacting_arena<Granule>::deallocate_block(handle_slot *const s)
+{
+	assert(s->block != nullptr);
+	memfree.set(calc_pos(s->block), calc_granules(s->nb));
+	s->block = nullptr;
+	s->nb = 0;
+	free_slots.push_back(s);
+}
+
+template <std::size_t Granule>
+void *compacting_arena<Granule>::calc_pointer(const size_type pos) const
+{
+	return start + pos * Granule;
+}
+
+template <std::size_t Granule>
+typename compacting_arena<Granule>::size_type compacting_arena<Granule>::calc_pos(const void *const p) const
+{
+	const byte *const b = static_cast<const byte *>(p);
+	assert(b >= start && (b - start) % Granule == 0);
+	return static_cast<size_type>(b - start) / Granule;
+}
+
+template <std::size_t Granule>
+typename compacting_arena<Granule>::byte *compacting_arena<Granule>::align_start(void *const memstart)
+{
+	const uintptr_t addr = reinterpret_cast<uintptr_t>(memstart);
+	return reinterpret_cast<byte *>((addr + Granule - 1) & ~static_cast<uintptr_t>(Granule - 1));
+}
+
+template <std::size_t Granule>
+typename compacting_arena<Granule>::size_type compacting_arena<Granule>::calc_memsize(void *const memstart, const size_type memsize)
+{
+	/* the bytes in front of the first aligned granule are not used */
+	const size_type skipped = static_cast<size_type>(align_start(memstart) - static_cast<byte *>(memstart));
+	return (skipped < memsize) ? (memsize - skipped) / Granule : 0;
+}
+
+template <std::size_t Granule>
+typename compacting_arena<Granule>::size_type compacting_arena<Granule>::calc_granules(const size_type nb)
+{
+	return (nb + Granule - 1) / Granule;
+}
+
+} /* namespace StaticMemoryAllocator */
+#endif /* STATIC_MEMORY_ALLOCATOR__COMPACTING_ARENA_IMPL_H__AD_ */
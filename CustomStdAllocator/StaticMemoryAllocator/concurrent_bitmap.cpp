@@ -0,0 +1,175 @@
+/**
+ * \file StaticMemoryAllocator\concurrent_bitmap.cpp
+ * \author Angelos Drossos <angelos.drossos@gmail.com>
+ */
+#include "concurrent_bitmap.hpp"
+#include "bitops.hpp"
+
+#include <algorithm>
+
+#include <assert.h>
+
+namespace StaticMemoryAllocator {
+
+namespace {
+
+using namespace bitops;
+
+const size_type bpw = concurrent_bitmap::bits_per_word;
+
+} /* anonymous namespace */
+
+concurrent_bitmap::concurrent_bitmap(const size_type nbits, const bool value)
+	: nbits(nbits),
+	  nwords(word_count(nbits)),
+	  words(new std::atomic<word_type>[word_count(nbits)]),
+	  nset(value ? nbits : 0)
+{
+	for (size_type i = 0; i < nwords; i++) {
+		words[i].store(value ? all_ones : 0, std::memory_order_relaxed);
+	}
+	/* bits behind size() are always cleared (i.e., never free) */
+	if (value && (nbits % bpw) != 0) {
+		words[nwords - 1].store(range_mask(0, nbits % bpw), std::memory_order_relaxed);
+	}
+}
+
+concurrent_bitmap::size_type concurrent_bitmap::size(void) const
+{
+	return nbits;
+}
+
+concurrent_bitmap::size_type concurrent_bitmap::count(void) const
+{
+	return nset.load(std::memory_order_relaxed);
+}
+
+bool concurrent_bitmap::test(const size_type pos) const
+{
+	assert(pos < nbits);
+	return (words[pos / bpw].load(std::memory_order_relaxed) >> (pos % bpw)) & 1;
+}
+
+bool concurrent_bitmap::all(const size_type pos, const size_type n) const
+{
+	assert(n > 0 && pos + n <= nbits);
+	const size_type first = pos / bpw;
+	const size_type last = (pos + n - 1) / bpw;
+	for (size_type i = first; i <= last; i++) {
+		const word_type m = range_mask((i == first) ? pos % bpw : 0,
+		                               (i == last) ? (pos + n - 1) % bpw + 1 : bpw);
+		if ((words[i].load(std::memory_order_relaxed) & m) != m) return false;
+	}
+	return true;
+}
+
+void concurrent_bitmap::set(const size_type pos, const size_type n)
+{
+	set_words(pos, n);
+	nset.fetch_add(n, std::memory_order_relaxed);
+}
+
+void concurrent_bitmap::set_words(const size_type pos, const size_type n)
+{
+	assert(n > 0 && pos + n <= nbits);
+	const size_type first = pos / bpw;
+	const size_type last = (pos + n - 1) / bpw;
+	for (size_type i = first; i <= last; i++) {
+		const word_type m = range_mask((i == first) ? pos % bpw : 0,
+		                               (i == last) ? (pos + n - 1) % bpw + 1 : bpw);
+		const word_type old = words[i].fetch_or(m, std::memory_order_release);
+		assert((old & m) == 0);
+		(void)old;
+	}
+}
+
+bool concurrent_bitmap::try_reset(const size_type pos, const size_type n)
+{
+	assert(n > 0 && pos + n <= nbits);
+	const size_type first = pos / bpw;
+	const size_type last = (pos + n - 1) / bpw;
+	for (size_type i = first; i <= last; i++) {
+		const word_type m = range_mask((i == first) ? pos % bpw : 0,
+		                               (i == last) ? (pos + n - 1) % bpw + 1 : bpw);
+		word_type w = words[i].load(std::memory_order_relaxed);
+		do {
+			if ((w & m) != m) {
+				/* (a part of) the run is not free anymore: release the words claimed so far */
+				if (i > first) set_words(pos, i * bpw - pos);
+				return false;
+			}
+		} while (!words[i].compare_exchange_weak(w, w & ~m,
+		                                          std::memory_order_acquire,
+		                                          std::memory_order_relaxed));
+	}
+	nset.fetch_sub(n, std::memory_order_relaxed);
+	return true;
+}
+
+concurrent_bitmap::size_type concurrent_bitmap::find_first(const size_type pos) const
+{
+	if (pos >= nbits) return nbits;
+	size_type i = pos / bpw;
+	word_type w = words[i].load(std::memory_order_relaxed) & (all_ones << (pos % bpw));
+	while (w == 0) {
+		if (++i == nwords) return nbits;
+		w = words[i].load(std::memory_order_relaxed);
+	}
+	return std::min(i * bpw + ctz(w), nbits);
+}
+
+concurrent_bitmap::size_type concurrent_bitmap::find_first_zero(const size_type pos) const
+{
+	if (pos >= nbits) return nbits;
+	size_type i = pos / bpw;
+	word_type w = ~words[i].load(std::memory_order_relaxed) & (all_ones << (pos % bpw));
+	while (w == 0) {
+		if (++i == nwords) return nbits;
+		w = ~words[i].load(std::memory_order_relaxed);
+	}
+	/* the (cleared) bits behind size() terminate the last run */
+	return std::min(i * bpw + ctz(w), nbits);
+}
+
+concurrent_bitmap::size_type concurrent_bitmap::find_run(const size_type n, const size_type pos) const
+{
+	assert(n > 0);
+	size_type start = find_first(pos);
+	while (start < nbits && n <= nbits - start) {
+		const size_type end = find_first_zero(start);
+		if (end - start >= n) return start;
+		start = find_first(end);
+	}
+	return nbits;
+}
+
+concurrent_bitmap::size_type concurrent_bitmap::longest_run(void) const
+{
+	size_type max = 0;
+	size_type start = find_first(0);
+	while (start < nbits) {
+		const size_type end = find_first_zero(start);
+		if (end - start > max) max = end - start;
+		start = find_first(end);
+	}
+	return max;
+}
+
+bool concurrent_bitmap::operator ==(const concurrent_bitmap & b) const
+{
+	if (nbits != b.nbits) return false;
+	for (size_type i = 0; i < nwords; i++) {
+		if (words[i].load(std::memory_order_relaxed) != b.words[i].load(std::memory_order_relaxed)) return false;
+	}
+	return true;
+}
+
+std::ostream & operator <<(std::ostream & os, const concurrent_bitmap & b)
+{
+	for (size_type i = b.size(); i > 0; i--) {
+		os << (b.test(i - 1) ? '1' : '0');
+	}
+	return os;
+}
+
+} /* namespace StaticMemoryAllocator */
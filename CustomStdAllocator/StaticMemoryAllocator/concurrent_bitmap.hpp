@@ -0,0 +1,110 @@
+#ifndef STATIC_MEMORY_ALLOCATOR__CONCURRENT_BITMAP_H__AD_
+#define STATIC_MEMORY_ALLOCATOR__CONCURRENT_BITMAP_H__AD_
+
+/**
+ * \file StaticMemoryAllocator\concurrent_bitmap.hpp
+ * \author Angelos Drossos <angelos.drossos@gmail.com>
+ */
+
+#include <atomic>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+#include <ostream>
+
+namespace StaticMemoryAllocator {
+
+/**
+ * Bitmap of the free memory of an allocator, which can be used
+ * by several threads at the same time (a set bit means free).
+ *
+ * The 64-bit words are atomics. Free runs are claimed by
+ * compare-and-swap word by word (in ascending order); if a word of
+ * the run was claimed by another thread in the meantime, the words
+ * claimed so far are released again and the claim fails.
+ * Releasing sets the bits by an atomic or, thus no mutex is needed.
+ *
+ * Searching is done on a snapshot of the words, which may already be
+ * outdated, thus only claiming decides whether a run is really free.
+ * There are no summaries (as in bitmap), since they could not be
+ * updated atomically together with the words.
+ */
+class concurrent_bitmap
+{
+public:
+	typedef uint64_t    word_type;
+	typedef std::size_t size_type;
+
+	static const size_type bits_per_word = 64;
+
+/* constructors, destructors, assignment operators */
+public:
+
+	concurrent_bitmap() = delete;
+
+	/**
+	 * Constructs a bitmap of \p nbits bits, all set to \p value.
+	 */
+	explicit concurrent_bitmap(const size_type nbits, const bool value = false);
+
+	concurrent_bitmap(const concurrent_bitmap & b) = delete;
+
+	concurrent_bitmap & operator =(const concurrent_bitmap & b) = delete;
+
+/* bitmap functions */
+public:
+
+	size_type size(void) const;
+
+	/**
+	 * Returns the number of set bits (kept up to date by each update,
+	 * thus it may be outdated while other threads update the bitmap).
+	 */
+	size_type count(void) const;
+
+	bool test(const size_type pos) const;
+
+	bool all(const size_type pos, const size_type n) const;
+
+	/**
+	 * Sets all bits in [pos, pos+n) atomically (word by word).
+	 */
+	void set(const size_type pos, const size_type n);
+
+	/**
+	 * Clears all bits in [pos, pos+n), if all of them are set.
+	 *
+	 * \return false (and nothing changed), if one of the bits
+	 *         was not set, e.g. since another thread cleared it.
+	 */
+	bool try_reset(const size_type pos, const size_type n);
+
+	size_type find_first(const size_type pos) const;
+
+	size_type find_first_zero(const size_type pos) const;
+
+	size_type find_run(const size_type n, const size_type pos = 0) const;
+
+	size_type longest_run(void) const;
+
+	bool operator ==(const concurrent_bitmap & b) const;
+
+	friend std::ostream & operator <<(std::ostream & os, const concurrent_bitmap & b);
+
+private:
+
+	/* sets the (cleared) bits in [pos, pos+n) without updating the count */
+	void set_words(const size_type pos, const size_type n);
+
+/* member variables */
+private:
+
+	size_type nbits;
+	size_type nwords;
+	std::unique_ptr<std::atomic<word_type>[]> words;
+	/* number of set bits */
+	std::atomic<size_type> nset;
+};
+
+} /* namespace StaticMemoryAllocator */
+#endif /* STATIC_MEMORY_ALLOCATOR__CONCURRENT_BITMAP_H__AD_ */
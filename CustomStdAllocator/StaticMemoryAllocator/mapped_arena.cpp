@@ -0,0 +1,237 @@
+/**
+ * \file StaticMemoryAllocator\mapped_arena.cpp
+ * \author Angelos Drossos <angelos.drossos@gmail.com>
+ */
+#include "mapped_arena.hpp"
+
+#include <cerrno>
+#include <cstdint>
+#include <fstream>
+#include <system_error>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <assert.h>
+
+namespace StaticMemoryAllocator {
+
+namespace {
+
+/* maps the open file fd with its size, or resizes it to memsize (if empty), closes fd on errors */
+void *map_shared(const int fd, std::size_t & memsize, const std::string & name)
+{
+	struct stat st;
+	if (::fstat(fd, &st) != 0) {
+		const int err = errno;
+		::close(fd);
+		throw std::system_error(err, std::generic_category(), "cannot stat " + name);
+	}
+	if (st.st_size > 0) {
+		memsize = static_cast<std::size_t>(st.st_size);
+	} else if (::ftruncate(fd, static_cast<off_t>(memsize)) != 0) {
+		const int err = errno;
+		::close(fd);
+		throw std::system_error(err, std::generic_category(), "cannot resize " + name);
+	}
+	void *const start = ::mmap(nullptr, memsize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	if (start == MAP_FAILED) {
+		const int err = errno;
+		::close(fd);
+		throw std::system_error(err, std::generic_category(), "cannot map " + name);
+	}
+	return start;
+}
+
+/* faults the pages of the memory block in (writable), after madvise() */
+void populate(void *const start, const std::size_t memsize)
+{
+#ifdef MADV_POPULATE_WRITE
+	if (::madvise(start, memsize, MADV_POPULATE_WRITE) == 0) return;
+#endif
+	/* older kernels: write to each page */
+	const std::size_t page = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+	volatile uint8_t *const b = static_cast<uint8_t *>(start);
+	for (std::size_t i = 0; i < memsize; i += page) b[i] = 0;
+}
+
+} /* namespace */
+
+mapped_file::mapped_file(const std::string & path, const size_type memsize)
+	: fd(-1),
+	  start(MAP_FAILED),
+	  memsize(memsize),
+	  filepath(path)
+{
+	fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+	if (fd < 0) {
+		throw std::system_error(errno, std::generic_category(), "cannot open " + path);
+	}
+	start = map_shared(fd, this->memsize, path);
+}
+
+mapped_file::~mapped_file()
+{
+	::munmap(start, memsize);
+	::close(fd);
+}
+
+void *mapped_file::data(void) const
+{
+	return start;
+}
+
+mapped_file::size_type mapped_file::size(void) const
+{
+	return memsize;
+}
+
+const std::string & mapped_file::path(void) const
+{
+	return filepath;
+}
+
+void mapped_file::sync(void) const
+{
+	if (::msync(start, memsize, MS_SYNC) != 0) {
+		throw std::system_error(errno, std::generic_category(), "cannot sync " + filepath);
+	}
+}
+
+shared_memory::shared_memory(const std::string & name, const size_type memsize)
+	: start(MAP_FAILED),
+	  memsize(memsize),
+	  shmname(name)
+{
+	const int fd = ::shm_open(name.c_str(), O_RDWR | O_CREAT, 0600);
+	if (fd < 0) {
+		throw std::system_error(errno, std::generic_category(), "cannot open shared memory " + name);
+	}
+	start = map_shared(fd, this->memsize, name);
+	/* the mapping stays valid without the descriptor */
+	::close(fd);
+}
+
+shared_memory::~shared_memory()
+{
+	::munmap(start, memsize);
+}
+
+void *shared_memory::data(void) const
+{
+	return start;
+}
+
+shared_memory::size_type shared_memory::size(void) const
+{
+	return memsize;
+}
+
+const std::string & shared_memory::name(void) const
+{
+	return shmname;
+}
+
+void shared_memory::remove(const std::string & name)
+{
+	::shm_unlink(name.c_str());
+}
+
+anonymous_memory::anonymous_memory(const size_type memsize, const unsigned flags)
+	: start(MAP_FAILED),
+	  memsize(memsize),
+	  thp(false)
+{
+	assert(memsize > 0);
+	if (flags & huge_pages) {
+		const size_type huge = huge_page_size();
+		this->memsize = (memsize + huge - 1) / huge * huge;
+		/* map one huge page more and unmap the parts in front of and behind the aligned block */
+		void *const p = ::mmap(nullptr, this->memsize + huge, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if (p == MAP_FAILED) {
+			throw std::system_error(errno, std::generic_category(), "cannot map anonymous memory");
+		}
+		const uintptr_t addr = reinterpret_cast<uintptr_t>(p);
+		const uintptr_t aligned = (addr + huge - 1) & ~static_cast<uintptr_t>(huge - 1);
+		if (aligned > addr) ::munmap(p, aligned - addr);
+		if (addr + huge > aligned) ::munmap(reinterpret_cast<void *>(aligned + this->memsize), addr + huge - aligned);
+		start = reinterpret_cast<void *>(aligned);
+		thp = ::madvise(start, this->memsize, MADV_HUGEPAGE) == 0;
+		/* MAP_POPULATE would fault the pages in before madvise(), i.e. as normal pages */
+		if (flags & prefault) populate(start, this->memsize);
+	} else {
+		const int populate_flag = (flags & prefault) ? MAP_POPULATE : 0;
+		start = ::mmap(nullptr, memsize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | populate_flag, -1, 0);
+		if (start == MAP_FAILED) {
+			throw std::system_error(errno, std::generic_category(), "cannot map anonymous memory");
+		}
+	}
+	if ((flags & locked) && ::mlock(start, this->memsize) != 0) {
+		const int err = errno;
+		::munmap(start, this->memsize);
+		throw std::system_error(err, std::generic_category(), "cannot lock anonymous memory");
+	}
+}
+
+anonymous_memory::~anonymous_memory()
+{
+	::munmap(start, memsize);
+}
+
+void *anonymous_memory::data(void) const
+{
+	return start;
+}
+
+anonymous_memory::size_type anonymous_memory::size(void) const
+{
+	return memsize;
+}
+
+bool anonymous_memory::transparent_huge_pages(void) const
+{
+	return thp;
+}
+
+anonymous_memory::size_type anonymous_memory::huge_page_size(void)
+{
+	static const size_type size = []() -> size_type {
+		std::ifstream f("/sys/kernel/mm/transparent_hugepage/hpage_pmd_size");
+		size_type n = 0;
+		return (f >> n && n > 0) ? n : 2 << 20;
+	}();
+	return size;
+}
+
+process_mutex::process_mutex()
+{
+	pthread_mutexattr_t attr;
+	pthread_mutexattr_init(&attr);
+	pthread_mutexattr_setpshared(&attr, PTHREAD_PROCESS_SHARED);
+	pthread_mutexattr_setrobust(&attr, PTHREAD_MUTEX_ROBUST);
+	const int err = pthread_mutex_init(&mutex, &attr);
+	pthread_mutexattr_destroy(&attr);
+	if (err != 0) {
+		throw std::system_error(err, std::generic_category(), "cannot initialize process mutex");
+	}
+}
+
+void process_mutex::lock(void)
+{
+	const int err = pthread_mutex_lock(&mutex);
+	if (err == EOWNERDEAD) {
+		/* the owner died while holding the lock: take it over */
+		pthread_mutex_consistent(&mutex);
+	} else if (err != 0) {
+		throw std::system_error(err, std::generic_category(), "cannot lock process mutex");
+	}
+}
+
+void process_mutex::unlock(void)
+{
+	pthread_mutex_unlock(&mutex);
+}
+
+} /* namespace StaticMemoryAllocator */
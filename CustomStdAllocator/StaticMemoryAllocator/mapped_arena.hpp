@@ -0,0 +1,442 @@
+#ifndef STATIC_MEMORY_ALLOCATOR__MAPPED_ARENA_H__AD_
+#define STATIC_MEMORY_ALLOCATOR__MAPPED_ARENA_H__AD_
+
+/**
+ * \file StaticMemoryAllocator\mapped_arena.hpp
+ * \author Angelos Drossos <angelos.drossos@gmail.com>
+ */
+
+#include "arena.hpp"
+#include "bitops.hpp"
+#include "offset_ptr.hpp"
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+
+#include <pthread.h>
+
+namespace StaticMemoryAllocator {
+
+/**
+ * File mapped into memory (shared, read and write), e.g. to be managed
+ * by a mapped_arena. The file is unmapped by the destructor.
+ */
+class mapped_file
+{
+public:
+	typedef std::size_t        size_type;
+
+/* constructors, destructors, assignment operators */
+public:
+
+	mapped_file() = delete;
+
+	/**
+	 * Maps the file \p path: an existing (non empty) file is mapped
+	 * with its size, otherwise the file is created with \p memsize bytes.
+	 *
+	 * \throw std::system_error If the file cannot be opened, created or mapped.
+	 */
+	mapped_file(const std::string & path, const size_type memsize);
+
+	mapped_file(const mapped_file & f) = delete;
+
+	mapped_file & operator =(const mapped_file & f) = delete;
+
+	~mapped_file();
+
+/* mapped file functions */
+public:
+
+	void *data(void) const;
+
+	size_type size(void) const;
+
+	const std::string & path(void) const;
+
+	/**
+	 * Writes the mapped memory back to the file (and waits for it).
+	 */
+	void sync(void) const;
+
+/* member variables */
+private:
+
+	int fd;
+	void *start;
+	size_type memsize;
+	std::string filepath;
+};
+
+/**
+ * POSIX shared memory object (shm_open()) mapped into memory,
+ * e.g. to be managed by a shared_arena of several processes.
+ * The memory is unmapped by the destructor, the object stays
+ * until it is removed by remove().
+ */
+class shared_memory
+{
+public:
+	typedef std::size_t        size_type;
+
+/* constructors, destructors, assignment operators */
+public:
+
+	shared_memory() = delete;
+
+	/**
+	 * Maps the shared memory object \p name (e.g. "/queue"): an existing
+	 * (non empty) object is mapped with its size, otherwise the object
+	 * is created with \p memsize bytes.
+	 *
+	 * \throw std::system_error If the object cannot be opened, created or mapped.
+	 */
+	shared_memory(const std::string & name, const size_type memsize);
+
+	shared_memory(const shared_memory & m) = delete;
+
+	shared_memory & operator =(const shared_memory & m) = delete;
+
+	~shared_memory();
+
+/* shared memory functions */
+public:
+
+	void *data(void) const;
+
+	size_type size(void) const;
+
+	const std::string & name(void) const;
+
+	/**
+	 * Removes the shared memory object \p name (mappings stay valid).
+	 */
+	static
+	void remove(const std::string & name);
+
+/* member variables */
+private:
+
+	void *start;
+	size_type memsize;
+	std::string shmname;
+};
+
+/**
+ * Anonymous (private) memory mapped for a large arena, e.g.:
+ *
+ * 	anonymous_memory mem(4ull << 30, anonymous_memory::huge_pages | anonymous_memory::prefault);
+ * 	bitmap_arena<> arena(mem.data(), mem.size(), "large");
+ *
+ * Transparent huge pages reduce the TLB misses of random accesses and
+ * the page faults of the first touches (one per huge page instead of
+ * one per page). Prefaulting moves all page faults into the constructor,
+ * thus the first allocations do not pay for them. The memory is unmapped
+ * by the destructor.
+ */
+class anonymous_memory
+{
+public:
+	typedef std::size_t        size_type;
+
+	/**
+	 * Options of the mapping (combined by |).
+	 */
+	enum options : unsigned
+	{
+		none = 0,
+		/*
+		 * align the memory to huge pages and madvise(MADV_HUGEPAGE) it,
+		 * the size is rounded up to a multiple of the huge page size
+		 */
+		huge_pages = 1,
+		/* fault all pages in (MAP_POPULATE) */
+		prefault = 2,
+		/* mlock() the memory (which faults it in as well) */
+		locked = 4
+	};
+
+/* constructors, destructors, assignment operators */
+public:
+
+	anonymous_memory() = delete;
+
+	/**
+	 * Maps \p memsize bytes (zero filled) with the options \p flags.
+	 *
+	 * If the kernel does not support transparent huge pages, the memory
+	 * is mapped with normal pages (see transparent_huge_pages()).
+	 *
+	 * \throw std::system_error If the memory cannot be mapped or locked
+	 *        (e.g. beyond RLIMIT_MEMLOCK).
+	 */
+	explicit anonymous_memory(const size_type memsize, const unsigned flags = none);
+
+	anonymous_memory(const anonymous_memory & m) = delete;
+
+	anonymous_memory & operator =(const anonymous_memory & m) = delete;
+
+	~anonymous_memory();
+
+/* anonymous memory functions */
+public:
+
+	void *data(void) const;
+
+	size_type size(void) const;
+
+	/**
+	 * Returns whether the kernel accepted the memory for transparent huge pages
+	 * (it may still use normal pages, if no huge page is available).
+	 */
+	bool transparent_huge_pages(void) const;
+
+	/**
+	 * Returns the size of a huge page (usually 2 MB).
+	 */
+	static
+	size_type huge_page_size(void);
+
+/* member variables */
+private:
+
+	void *start;
+	size_type memsize;
+	bool thp;
+};
+
+/**
+ * Lock of a mapped_arena used by one process (and one thread) only:
+ * does nothing.
+ */
+struct null_mutex
+{
+	void lock(void) {}
+
+	void unlock(void) {}
+};
+
+/**
+ * Lock of a mapped_arena used by several processes: a process shared,
+ * robust pthread mutex, which is stored in the memory block.
+ *
+ * If a process dies while holding the lock, the next process locking it
+ * takes it over. The bitmap is still consistent then, except that
+ * granules of an interrupted allocation may stay reserved (i.e., leak).
+ */
+class process_mutex
+{
+/* constructors, destructors, assignment operators */
+public:
+
+	process_mutex();
+
+	process_mutex(const process_mutex & m) = delete;
+
+	process_mutex & operator =(const process_mutex & m) = delete;
+
+/* mutex functions */
+public:
+
+	void lock(void);
+
+	void unlock(void);
+
+/* member variables */
+private:
+
+	pthread_mutex_t mutex;
+};
+
+/**
+ * Arena of a memory block, which can be mapped at a different address
+ * each time (e.g. a mapped_file), and thus survives a restart of the process.
+ *
+ * The arena itself (i.e., its bitmap, one bit per granule of \p Granule bytes,
+ * and its name) is placed at the start of the memory block, the managed
+ * memory follows behind it. All pointers into the memory block (those of the
+ * allocators, see arena_pointer, and the root) are offset_ptr, thus
+ * containers in the block, e.g. std::vector<T, allocator<T, mapped_arena<>>>,
+ * can be used again after mapping the block again without deserialization:
+ *
+ * 	mapped_file file("lookup.bin", 64 << 20);
+ * 	mapped_arena<> & arena = mapped_arena<>::attach(file.data(), file.size(), "lookup");
+ * 	vec_type *v = static_cast<vec_type *>(arena.root());
+ * 	if (v == nullptr) {
+ * 		v = new (arena.allocate(sizeof(vec_type), alignof(vec_type))) vec_type(alloc_type(arena));
+ * 		arena.set_root(v);
+ * 	}
+ *
+ * Only trivially relocatable objects without absolute addresses
+ * (i.e., no plain pointers, no std::string) may be stored in the block.
+ * Changes are not crash safe: the file is consistent, if it was
+ * unmapped (or synced) in a consistent state.
+ *
+ * \tparam Granule Size of a granule in bytes (a power of two),
+ *         the managed memory is aligned to it.
+ * \tparam Mutex Lock of the bitmap (stored in the memory block):
+ *         null_mutex (the arena must not be used by several threads
+ *         or processes at the same time), or process_mutex.
+ */
+template <std::size_t Granule = 16, class Mutex = null_mutex>
+class mapped_arena
+{
+	static_assert(Granule > 0 && (Granule & (Granule - 1)) == 0,
+	              "the granule size has to be a power of two");
+
+public:
+	typedef std::size_t        size_type;
+
+	static const size_type granule_size = Granule;
+
+	/**
+	 * Maximal length of the name, which is stored in the memory block.
+	 */
+	static const size_type name_capacity = 64;
+
+/* constructors, destructors, assignment operators */
+public:
+
+	mapped_arena() = delete;
+
+	mapped_arena(const mapped_arena & a) = delete;
+
+	mapped_arena & operator =(const mapped_arena & a) = delete;
+
+	/**
+	 * Returns the arena at the start of the memory block \p memstart
+	 * (aligned to \p Granule), which is constructed, unless the block
+	 * already contains an arena (of the same granule and block size).
+	 *
+	 * \throw std::runtime_error If the block contains an arena
+	 *        of a different granule or block size, or is too small.
+	 */
+	static
+	mapped_arena & attach(void *const memstart, const size_type memsize, const std::string & memname = "");
+
+/* arena functions */
+public:
+
+	/**
+	 * Reserves a memory block of (at least) \p nb bytes.
+	 *
+	 * \param nb Size of the memory block in bytes.
+	 * \param alignment Alignment of the memory block (a power of two).
+	 * \param hint Not used.
+	 * \return Pointer to the memory block, or nullptr if there is no
+	 *         large enough (and aligned) free memory block.
+	 */
+	void *allocate(const size_type nb, const size_type alignment, void *const hint = nullptr);
+
+	void deallocate(void *const p, const size_type nb);
+
+	bool expand(void *const p, const size_type old_nb, const size_type new_nb);
+
+	bool shrink(void *const p, const size_type old_nb, const size_type new_nb);
+
+	/**
+	 * Returns the size of the largest free memory block in bytes.
+	 */
+	size_type max_size(void) const;
+
+	/**
+	 * Returns the size of the managed memory in bytes
+	 * (i.e., without the arena at the start of the memory block).
+	 */
+	size_type size(void) const;
+
+	void *const memstart(void) const;
+
+	void *const memend(void) const;
+
+	/**
+	 * Returns the name (which is stored in the memory block, thus by value).
+	 */
+	std::string name(void) const;
+
+	bool operator ==(const mapped_arena & a) const;
+
+	void print_free_memory(void) const;
+
+/* root object */
+public:
+
+	/**
+	 * Returns the root object (e.g. a container, from which all other
+	 * objects in the memory block can be reached), or nullptr if not set.
+	 */
+	void *root(void) const;
+
+	void set_root(void *const p);
+
+private:
+
+	typedef uint8_t byte;
+	typedef bitops::word_type word_type;
+
+	static const uint64_t magic_number = 0x31304d414d534d41ull; /* "AMSMAM01" */
+
+	mapped_arena(const size_type memsize, const std::string & memname);
+
+	static
+	size_type calc_granules(const size_type nb);
+
+	size_type calc_pos(const void *const p) const;
+
+	/* size of the arena (without its bitmap) at the start of the memory block */
+	static
+	size_type header_size(void);
+
+	byte *data(void) const;
+
+	word_type *words(void) const;
+
+	bool test(const size_type pos) const;
+
+	bool all(const size_type pos, const size_type n) const;
+
+	void assign(const size_type pos, const size_type n, const bool value);
+
+	/* first set (value) or cleared (!value) bit in [pos, granule_count) */
+	size_type find(const size_type pos, const bool value) const;
+
+	size_type find_free_memory(const size_type ng, const size_type alignment) const;
+
+/* member variables */
+private:
+
+	/* all members are stored in the memory block: no absolute addresses */
+	uint64_t magic;
+	uint64_t granule;
+	uint64_t blocksize;
+	uint64_t granule_count;
+	/* offset of the managed memory from the arena, the bitmap is in between */
+	uint64_t data_offset;
+	offset_ptr<void> rootptr;
+	char memname[name_capacity];
+	mutable Mutex memlock;
+};
+
+/**
+ * Arena in shared memory (e.g. a shared_memory object), which can be
+ * shared by allocators of several processes: containers (and their
+ * elements) are exchanged by offset pointers without copying.
+ *
+ * One process has to attach() the memory block first,
+ * before the other processes attach it.
+ */
+template <std::size_t Granule = 16>
+using shared_arena = mapped_arena<Granule, process_mutex>;
+
+/**
+ * The allocators of a mapped_arena use offset pointers.
+ */
+template <std::size_t Granule, class Mutex, class T>
+struct arena_pointer<mapped_arena<Granule, Mutex>, T>
+{
+	typedef offset_ptr<T> type;
+};
+
+} /* namespace StaticMemoryAllocator */
+#endif /* STATIC_MEMORY_ALLOCATOR__MAPPED_ARENA_H__AD_ */
@@ -0,0 +1,270 @@
+#ifndef STATIC_MEMORY_ALLOCATOR__MAPPED_ARENA_IMPL_H__AD_
+#define STATIC_MEMORY_ALLOCATOR__MAPPED_ARENA_IMPL_H__AD_
+
+#include "mapped_arena.hpp"
+
+#include <iostream>
+#include <new>
+#include <stdexcept>
+#include <cstring>
+#include <mutex>
+
+#include <assert.h>
+
+namespace StaticMemoryAllocator {
+
+template <std::size_t Granule, class Mutex>
+mapped_arena<Granule, Mutex> & mapped_arena<Granule, Mutex>::attach(void *const memstart, const size_type memsize, const std::string & memname)
+{
+	assert(memstart != nullptr);
+	assert(reinterpret_cast<uintptr_t>(memstart) % Granule == 0);
+	assert(reinterpret_cast<uintptr_t>(memstart) % alignof(mapped_arena) == 0);
+	if (memsize < sizeof(mapped_arena) + sizeof(word_type) + Granule) {
+		throw std::runtime_error("memory block too small for a mapped arena");
+	}
+	mapped_arena *const a = static_cast<mapped_arena *>(memstart);
+	if (a->magic != magic_number) {
+		return *new (memstart) mapped_arena(memsize, memname);
+	}
+	if (a->granule != Granule || a->blocksize != memsize) {
+		throw std::runtime_error("memory block contains a mapped arena of a different granule or size");
+	}
+	return *a;
+}
+
+template <std::size_t Granule, class Mutex>
+mapped_arena<Granule, Mutex>::mapped_arena(const size_type memsize, const std::string & memname)
+	: magic(0),
+	  granule(Granule),
+	  blocksize(memsize),
+	  granule_count(0),
+	  data_offset(0),
+	  rootptr(nullptr)
+{
+	/* a granule costs Granule bytes of memory and one bit of the bitmap (rounded up to words and the alignment) */
+	const size_type header = header_size();
+	size_type ng = (memsize - header) / Granule * 8 * Granule / (8 * Granule + 1);
+	size_type offset = 0;
+	for (; ng > 0; ng--) {
+		offset = (header + bitops::word_count(ng) * sizeof(word_type) + Granule - 1) / Granule * Granule;
+		if (offset + ng * Granule <= memsize) break;
+	}
+	if (ng == 0) {
+		throw std::runtime_error("memory block too small for a mapped arena");
+	}
+	granule_count = ng;
+	data_offset = offset;
+	std::strncpy(this->memname, memname.c_str(), name_capacity - 1);
+	this->memname[name_capacity - 1] = '\0';
+	const size_type nwords = bitops::word_count(granule_count);
+	std::memset(words(), 0, nwords * sizeof(word_type));
+	assign(0, granule_count, true);
+	/* written last: an interrupted construction is constructed again */
+	magic = magic_number;
+}
+
+template <std::size_t Granule, class Mutex>
+void *mapped_arena<Granule, Mutex>::allocate(const size_type nb, const size_type alignment, void *const hint)
+{
+	assert(nb > 0);
+	assert(alignment > 0 && (alignment & (alignment - 1)) == 0);
+	(void) hint;
+	if (nb > granule_count * Granule) return nullptr;
+	const size_type ng = calc_granules(nb);
+	std::lock_guard<Mutex> lock(memlock);
+	const size_type pos = find_free_memory(ng, alignment);
+	if (pos >= granule_count) return nullptr;
+	assign(pos, ng, false);
+	return data() + pos * Granule;
+}
+
+template <std::size_t Granule, class Mutex>
+void mapped_arena<Granule, Mutex>::deallocate(void *const p, const size_type nb)
+{
+	assert(nb > 0);
+	const size_type pos = calc_pos(p);
+	const size_type ng = calc_granules(nb);
+	assert(pos + ng <= granule_count);
+	std::lock_guard<Mutex> lock(memlock);
+	assert(find(pos, true) >= pos + ng);
+	assign(pos, ng, true);
+}
+
+template <std::size_t Granule, class Mutex>
+bool mapped_arena<Granule, Mutex>::expand(void *const p, const size_type old_nb, const size_type new_nb)
+{
+	assert(old_nb > 0 && new_nb > 0);
+	if (new_nb > granule_count * Granule) return false;
+	const size_type old_ng = calc_granules(old_nb);
+	const size_type new_ng = calc_granules(new_nb);
+	if (new_ng <= old_ng) return true;
+	const size_type pos = calc_pos(p);
+	std::lock_guard<Mutex> lock(memlock);
+	if (pos + new_ng > granule_count || !all(pos + old_ng, new_ng - old_ng)) return false;
+	assign(pos + old_ng, new_ng - old_ng, false);
+	return true;
+}
+
+template <std::size_t Granule, class Mutex>
+bool mapped_arena<Granule, Mutex>::shrink(void *const p, const size_type old_nb, const size_type new_nb)
+{
+	assert(old_nb > 0 && new_nb > 0);
+	const size_type old_ng = calc_granules(old_nb);
+	const size_type new_ng = calc_granules(new_nb);
+	if (new_ng < old_ng) {
+		std::lock_guard<Mutex> lock(memlock);
+		assign(calc_pos(p) + new_ng, old_ng - new_ng, true);
+	}
+	return true;
+}
+
+template <std::size_t Granule, class Mutex>
+typename mapped_arena<Granule, Mutex>::size_type mapped_arena<Granule, Mutex>::max_size(void) const
+{
+	std::lock_guard<Mutex> lock(memlock);
+	size_type longest = 0;
+	for (size_type pos = find(0, true); pos < granule_count; ) {
+		const size_type last = find(pos, false);
+		if (last - pos > longest) longest = last - pos;
+		pos = find(last, true);
+	}
+	return longest * Granule;
+}
+
+template <std::size_t Granule, class Mutex>
+typename mapped_arena<Granule, Mutex>::size_type mapped_arena<Granule, Mutex>::size(void) const
+{
+	return granule_count * Granule;
+}
+
+template <std::size_t Granule, class Mutex>
+void *const mapped_arena<Granule, Mutex>::memstart(void) const
+{
+	return data();
+}
+
+template <std::size_t Granule, class Mutex>
+void *const mapped_arena<Granule, Mutex>::memend(void) const
+{
+	return data() + granule_count * Granule;
+}
+
+template <std::size_t Granule, class Mutex>
+std::string mapped_arena<Granule, Mutex>::name(void) const
+{
+	return std::string(memname);
+}
+
+template <std::size_t Granule, class Mutex>
+bool mapped_arena<Granule, Mutex>::operator ==(const mapped_arena & a) const
+{
+	return this == &a;
+}
+
+template <std::size_t Granule, class Mutex>
+void mapped_arena<Granule, Mutex>::print_free_memory(void) const
+{
+	std::lock_guard<Mutex> lock(memlock);
+	std::cout << "free memory (" << ((memname[0] == '\0') ? "<unnamed>" : memname) << "): ";
+	for (size_type pos = granule_count; pos > 0; pos--) {
+		std::cout << (test(pos - 1) ? '1' : '0');
+	}
+	std::cout << " at (" << memend() << ", " << memstart() << "]" << std::endl;
+}
+
+template <std::size_t Granule, class Mutex>
+void *mapped_arena<Granule, Mutex>::root(void) const
+{
+	std::lock_guard<Mutex> lock(memlock);
+	return rootptr.get();
+}
+
+template <std::size_t Granule, class Mutex>
+void mapped_arena<Granule, Mutex>::set_root(void *const p)
+{
+	assert(p == nullptr || (p >= memstart() && p < memend()));
+	std::lock_guard<Mutex> lock(memlock);
+	rootptr = p;
+}
+
+template <std::size_t Granule, class Mutex>
+typename mapped_arena<Granule, Mutex>::size_type mapped_arena<Granule, Mutex>::calc_granules(const size_type nb)
+{
+	return (nb + Granule - 1) / Granule;
+}
+
+template <std::size_t Granule, class Mutex>
+typename mapped_arena<Granule, Mutex>::size_type mapped_arena<Granule, Mutex>::calc_pos(const void *const p) const
+{
+	const byte *const b = static_cast<const byte *>(p);
+	assert(b >= data() && b < data() + granule_count * Granule);
+	assert((b - data()) % Granule == 0);
+	return static_cast<size_type>(b - data()) / Granule;
+}
+
+template <std::size_t Granule, class Mutex>
+typename mapped_arena<Granule, Mutex>::size_type mapped_arena<Granule, Mutex>::header_size(void)
+{
+	/* the bitmap follows the arena, aligned to its words */
+	return (sizeof(mapped_arena) + sizeof(word_type) - 1) / sizeof(word_type) * sizeof(word_type);
+}
+
+template <std::size_t Granule, class Mutex>
+typename mapped_arena<Granule, Mutex>::byte *mapped_arena<Granule, Mutex>::data(void) const
+{
+	return reinterpret_cast<byte *>(const_cast<mapped_arena *>(this)) + data_offset;
+}
+
+template <std::size_t Granule, class Mutex>
+typename mapped_arena<Granule, Mutex>::word_type *mapped_arena<Granule, Mutex>::words(void) const
+{
+	return reinterpret_cast<word_type *>(reinterpret_cast<byte *>(const_cast<mapped_arena *>(this)) + header_size());
+}
+
+template <std::size_t Granule, class Mutex>
+bool mapped_arena<Granule, Mutex>::test(const size_type pos) const
+{
+	assert(pos < granule_count);
+	return (words()[pos / bitops::bits_per_word] >> (pos % bitops::bits_per_word)) & 1;
+}
+
+template <std::size_t Granule, class Mutex>
+bool mapped_arena<Granule, Mutex>::all(const size_type pos, const size_type n) const
+{
+	return find(pos, false) >= pos + n;
+}
+
+template <std::size_t Granule, class Mutex>
+void mapped_arena<Granule, Mutex>::assign(const size_type pos, const size_type n, const bool value)
+{
+	assert(pos + n <= granule_count);
+	bitops::assign(words(), pos, n, value);
+}
+
+template <std::size_t Granule, class Mutex>
+typename mapped_arena<Granule, Mutex>::size_type mapped_arena<Granule, Mutex>::find(const size_type pos, const bool value) const
+{
+	return bitops::find(words(), granule_count, pos, value);
+}
+
+template <std::size_t Granule, class Mutex>
+typename mapped_arena<Granule, Mutex>::size_type mapped_arena<Granule, Mutex>::find_free_memory(const size_type ng, const size_type alignment) const
+{
+	/* the memory block is aligned to the granule size, for larger alignments only each stride-th granule is aligned */
+	const size_type stride = (alignment > Granule) ? alignment / Granule : 1;
+	const size_type offset = (stride > 1)
+		? ((alignment - reinterpret_cast<uintptr_t>(data()) % alignment) % alignment) / Granule
+		: 0;
+	for (size_type pos = find(0, true); pos < granule_count; ) {
+		const size_type aligned = pos + (offset + stride - pos % stride) % stride;
+		if (aligned + ng > granule_count) break;
+		/* the end of the free run matters only up to the end of the block */
+		const size_type last = bitops::find(words(), aligned + ng, pos, false);
+		if (aligned + ng <= last) return aligned;
+		pos = find(last, true);
+	}
+	return granule_count;
+}
+
+} /* namespace StaticMemoryAllocator */
+#endif /* STATIC_MEMORY_ALLOCATOR__MAPPED_ARENA_IMPL_H__AD_ */
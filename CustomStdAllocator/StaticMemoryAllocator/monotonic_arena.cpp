@@ -0,0 +1,143 @@
+/**
+ * \file StaticMemoryAllocator\monotonic_arena.cpp
+ * \author Angelos Drossos <angelos.drossos@gmail.com>
+ */
+#include "monotonic_arena.hpp"
+
+#include <iostream>
+
+#include <assert.h>
+
+namespace StaticMemoryAllocator {
+
+namespace {
+
+inline uintptr_t align_up(const uintptr_t addr, const std::size_t alignment)
+{
+	return (addr + alignment - 1) & ~static_cast<uintptr_t>(alignment - 1);
+}
+
+} /* namespace */
+
+monotonic_arena::monotonic_arena(void *const memstart, const size_type memsize, const std::string & memname)
+	: start(static_cast<byte *>(memstart)),
+	  end(static_cast<byte *>(memstart) + memsize),
+	  top(static_cast<byte *>(memstart)),
+	  last(nullptr),
+	  memname(memname)
+{
+	assert(memstart != nullptr);
+	assert(memsize > 0);
+}
+
+void *monotonic_arena::allocate(const size_type nb, const size_type alignment, void *const hint)
+{
+	assert(nb > 0);
+	assert(alignment > 0 && (alignment & (alignment - 1)) == 0);
+	(void) hint;
+	const uintptr_t p = align_up(reinterpret_cast<uintptr_t>(top), alignment);
+	if (p > reinterpret_cast<uintptr_t>(end) || nb > reinterpret_cast<uintptr_t>(end) - p) return nullptr;
+	last = reinterpret_cast<byte *>(p);
+	top = last + nb;
+	return last;
+}
+
+void monotonic_arena::deallocate(void *const p, const size_type nb)
+{
+	assert(static_cast<byte *>(p) >= start && static_cast<byte *>(p) + nb <= top);
+	(void) p;
+	(void) nb;
+}
+
+bool monotonic_arena::expand(void *const p, const size_type old_nb, const size_type new_nb)
+{
+	assert(old_nb > 0 && new_nb > 0);
+	if (new_nb <= old_nb) return true;
+	if (p != last || last + old_nb != top) return false;
+	if (new_nb > static_cast<size_type>(end - last)) return false;
+	top = last + new_nb;
+	return true;
+}
+
+bool monotonic_arena::shrink(void *const p, const size_type old_nb, const size_type new_nb)
+{
+	assert(old_nb > 0 && new_nb > 0);
+	if (new_nb < old_nb && p == last && last + old_nb == top) {
+		top = last + new_nb;
+	}
+	return true;
+}
+
+monotonic_arena::size_type monotonic_arena::max_size(void) const
+{
+	return static_cast<size_type>(end - top);
+}
+
+monotonic_arena::size_type monotonic_arena::size(void) const
+{
+	return static_cast<size_type>(end - start);
+}
+
+void *const monotonic_arena::memstart(void) const
+{
+	return start;
+}
+
+void *const monotonic_arena::memend(void) const
+{
+	return end;
+}
+
+const std::string & monotonic_arena::name(void) const
+{
+	return memname;
+}
+
+bool monotonic_arena::operator ==(const monotonic_arena & a) const
+{
+	return this == &a;
+}
+
+void monotonic_arena::print_free_memory(void) const
+{
+	std::cout << "free memory (" << ((memname.empty()) ? "<unnamed>" : memname) << "): "
+		  << max_size() << " bytes at [" << static_cast<void *>(top) << ", " << static_cast<void *>(end) << ")"
+		  << std::endl;
+}
+
+void monotonic_arena::reset(void)
+{
+	top = start;
+	last = nullptr;
+}
+
+monotonic_arena::marker monotonic_arena::mark(void) const
+{
+	return static_cast<marker>(top - start);
+}
+
+void monotonic_arena::release(const marker m)
+{
+	assert(m <= used());
+	top = start + m;
+	/* the block in front of the marker must not grow over it */
+	last = nullptr;
+}
+
+monotonic_arena::size_type monotonic_arena::used(void) const
+{
+	return static_cast<size_type>(top - start);
+}
+
+monotonic_scope::monotonic_scope(monotonic_arena & a)
+	: arena(a),
+	  saved(a.mark())
+{
+}
+
+monotonic_scope::~monotonic_scope()
+{
+	arena.release(saved);
+}
+
+} /* namespace StaticMemoryAllocator */
@@ -0,0 +1,164 @@
+#ifndef STATIC_MEMORY_ALLOCATOR__MONOTONIC_ARENA_H__AD_
+#define STATIC_MEMORY_ALLOCATOR__MONOTONIC_ARENA_H__AD_
+
+/**
+ * \file StaticMemoryAllocator\monotonic_arena.hpp
+ * \author Angelos Drossos <angelos.drossos@gmail.com>
+ */
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+
+namespace StaticMemoryAllocator {
+
+/**
+ * Manages a static memory block [memstart, memend()) by bumping a pointer,
+ * e.g. for the allocations of one request, which all die together.
+ *
+ * Allocating moves the top of the used memory, deallocating does nothing
+ * (the memory is reused only after reset() or release()). There is no
+ * metadata but the top, thus allocating is a few instructions and
+ * releasing all memory is O(1). Nested scopes save the top by mark()
+ * and release the memory allocated behind it by release() (see monotonic_scope).
+ *
+ * The arena must not be used by several threads at the same time.
+ */
+class monotonic_arena
+{
+public:
+	typedef std::size_t        size_type;
+
+	/**
+	 * Saved top of the used memory (see mark() and release()).
+	 */
+	typedef size_type          marker;
+
+/* constructors, destructors, assignment operators */
+public:
+
+	monotonic_arena() = delete;
+
+	monotonic_arena(void *const memstart, const size_type memsize, const std::string & memname = "");
+
+	monotonic_arena(const monotonic_arena & a) = delete;
+
+	monotonic_arena & operator =(const monotonic_arena & a) = delete;
+
+/* arena functions */
+public:
+
+	/**
+	 * Reserves a memory block of \p nb bytes at the top of the used memory.
+	 *
+	 * \param nb Size of the memory block in bytes.
+	 * \param alignment Alignment of the memory block (a power of two).
+	 * \param hint Not used.
+	 * \return Pointer to the memory block, or nullptr if there is not
+	 *         enough memory left behind the top.
+	 */
+	void *allocate(const size_type nb, const size_type alignment, void *const hint = nullptr);
+
+	/**
+	 * Does nothing: the memory is released by reset() or release().
+	 */
+	void deallocate(void *const p, const size_type nb);
+
+	/**
+	 * Grows the memory block at \p p to \p new_nb bytes,
+	 * if it is the last allocated block and enough memory is left.
+	 *
+	 * \return false (and nothing changed), if the block cannot grow in place.
+	 */
+	bool expand(void *const p, const size_type old_nb, const size_type new_nb);
+
+	/**
+	 * Shrinks the memory block at \p p to \p new_nb bytes
+	 * (only the last allocated block gives memory back).
+	 */
+	bool shrink(void *const p, const size_type old_nb, const size_type new_nb);
+
+	/**
+	 * Returns the size of the memory left behind the top in bytes.
+	 */
+	size_type max_size(void) const;
+
+	size_type size(void) const;
+
+	void *const memstart(void) const;
+
+	void *const memend(void) const;
+
+	const std::string & name(void) const;
+
+	bool operator ==(const monotonic_arena & a) const;
+
+	void print_free_memory(void) const;
+
+/* monotonic functions */
+public:
+
+	/**
+	 * Releases all memory at once (all allocated objects have to be dead).
+	 */
+	void reset(void);
+
+	/**
+	 * Returns the current top of the used memory.
+	 */
+	marker mark(void) const;
+
+	/**
+	 * Releases all memory allocated since mark() returned \p m
+	 * (markers have to be released in reverse order).
+	 */
+	void release(const marker m);
+
+	/**
+	 * Returns the size of the used memory in bytes.
+	 */
+	size_type used(void) const;
+
+private:
+
+	typedef uint8_t byte;
+
+/* member variables */
+private:
+
+	byte *start;
+	byte *end;
+	byte *top;
+	/* the last allocated block (which may grow and shrink in place) */
+	byte *last;
+	std::string memname;
+};
+
+/**
+ * Releases the memory allocated in a scope of a monotonic_arena,
+ * i.e. since the construction, when destructed.
+ */
+class monotonic_scope
+{
+/* constructors, destructors, assignment operators */
+public:
+
+	monotonic_scope() = delete;
+
+	explicit monotonic_scope(monotonic_arena & a);
+
+	monotonic_scope(const monotonic_scope & s) = delete;
+
+	monotonic_scope & operator =(const monotonic_scope & s) = delete;
+
+	~monotonic_scope();
+
+/* member variables */
+private:
+
+	monotonic_arena & arena;
+	const monotonic_arena::marker saved;
+};
+
+} /* namespace StaticMemoryAllocator */
+#endif /* STATIC_MEMORY_ALLOCATOR__MONOTONIC_ARENA_H__AD_ */
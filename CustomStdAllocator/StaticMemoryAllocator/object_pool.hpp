@@ -0,0 +1,141 @@
+#ifndef STATIC_MEMORY_ALLOCATOR__OBJECT_POOL_H__AD_
+#define STATIC_MEMORY_ALLOCATOR__OBJECT_POOL_H__AD_
+
+/**
+ * \file StaticMemoryAllocator\object_pool.hpp
+ * \author Angelos Drossos <angelos.drossos@gmail.com>
+ */
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+
+namespace StaticMemoryAllocator {
+
+/**
+ * Pool of objects of type \p T in a static memory block [memstart, memend()),
+ * e.g. for hot objects of a fixed size.
+ *
+ * The memory block is split into slots of sizeof(T) bytes (at least
+ * a pointer), aligned to alignof(T). Freed slots are kept in an intrusive
+ * list inside the slots themselves, slots which were never used are
+ * taken from the end of the used slots. Thus there is no metadata per slot
+ * (unlike one bit per granule of a bitmap_arena), and creating and
+ * destroying an object is O(1).
+ *
+ * The pool must not be used by several threads at the same time.
+ *
+ * \tparam T Type of the objects.
+ */
+template <class T>
+class object_pool
+{
+public:
+	typedef T                  value_type;
+	typedef value_type       * pointer;
+	typedef std::size_t        size_type;
+
+/* constructors, destructors, assignment operators */
+public:
+
+	object_pool() = delete;
+
+	object_pool(void *const memstart, const size_type memsize, const std::string & memname = "");
+
+	object_pool(const object_pool & p) = delete;
+
+	object_pool & operator =(const object_pool & p) = delete;
+
+	/**
+	 * Does not destroy the objects left in the pool.
+	 */
+	~object_pool() = default;
+
+/* pool functions */
+public:
+
+	/**
+	 * Constructs an object in a free slot by forwarding \p args
+	 * to the constructor of T (as allocator::construct() does).
+	 *
+	 * \throw std::bad_alloc If there is no free slot.
+	 */
+	template <class... Args>
+	pointer create(Args&&... args);
+
+	/**
+	 * Constructs \p n objects as copies of T(args...) (or T(), if there are
+	 * no arguments) and stores their pointers to \p out.
+	 * Either all or none of the objects are created.
+	 *
+	 * \throw std::bad_alloc If there are less than \p n free slots.
+	 */
+	template <class... Args>
+	void create_n(pointer *const out, const size_type n, const Args &... args);
+
+	/**
+	 * Destroys the object at \p p (which was created by this pool) and frees its slot.
+	 */
+	void destroy(pointer p);
+
+	/**
+	 * Destroys the \p n objects of \p ps.
+	 */
+	void destroy_n(pointer const *const ps, const size_type n);
+
+	/**
+	 * Returns true, if \p p points into a slot of the pool.
+	 */
+	bool owns(const void *const p) const;
+
+	/**
+	 * Returns the number of free slots.
+	 */
+	size_type available(void) const;
+
+	/**
+	 * Returns the number of slots.
+	 */
+	size_type capacity(void) const;
+
+	void *const memstart(void) const;
+
+	void *const memend(void) const;
+
+	const std::string & name(void) const;
+
+	void print_free_memory(void) const;
+
+private:
+
+	typedef uint8_t byte;
+
+	struct free_slot
+	{
+		free_slot *next;
+	};
+
+	static const size_type slot_alignment = (alignof(T) > alignof(free_slot)) ? alignof(T) : alignof(free_slot);
+	static const size_type slot_size = ((sizeof(T) > sizeof(free_slot) ? sizeof(T) : sizeof(free_slot))
+	                                    + slot_alignment - 1) / slot_alignment * slot_alignment;
+
+	/* takes a free slot (n_free > 0) */
+	void *take(void);
+
+	void put(void *const p);
+
+/* member variables */
+private:
+
+	byte *start;
+	byte *end;
+	/* freed slots */
+	free_slot *free;
+	/* the slots from bump to end were never used */
+	byte *bump;
+	size_type n_free;
+	std::string memname;
+};
+
+} /* namespace StaticMemoryAllocator */
+#endif /* STATIC_MEMORY_ALLOCATOR__OBJECT_POOL_H__AD_ */
@@ -0,0 +1,154 @@
+#ifndef STATIC_MEMORY_ALLOCATOR__OBJECT_POOL_IMPL_H__AD_
+#define STATIC_MEMORY_ALLOCATOR__OBJECT_POOL_IMPL_H__AD_
+
+#include "object_pool.hpp"
+
+#include <iostream>
+#include <new>
+#include <utility>
+
+#include <assert.h>
+
+namespace StaticMemoryAllocator {
+
+template <class T>
+object_pool<T>::object_pool(void *const memstart, const size_type memsize, const std::string & memname)
+	: start(nullptr),
+	  end(nullptr),
+	  free(nullptr),
+	  bump(nullptr),
+	  n_free(0),
+	  memname(memname)
+{
+	assert(memstart != nullptr);
+	const uintptr_t first = (reinterpret_cast<uintptr_t>(memstart) + slot_alignment - 1) / slot_alignment * slot_alignment;
+	const uintptr_t last = reinterpret_cast<uintptr_t>(memstart) + memsize;
+	n_free = (first < last) ? (last - first) / slot_size : 0;
+	start = reinterpret_cast<byte *>(first);
+	end = start + n_free * slot_size;
+	bump = start;
+}
+
+template <class T>
+template <class... Args>
+typename object_pool<T>::pointer object_pool<T>::create(Args&&... args)
+{
+	if (n_free == 0) throw std::bad_alloc();
+	void *const p = take();
+	try {
+		return ::new (p) T(std::forward<Args>(args)...);
+	} catch (...) {
+		put(p);
+		throw;
+	}
+}
+
+template <class T>
+template <class... Args>
+void object_pool<T>::create_n(pointer *const out, const size_type n, const Args &... args)
+{
+	if (n > n_free) throw std::bad_alloc();
+	size_type i = 0;
+	try {
+		for (; i < n; i++) {
+			void *const p = take();
+			try {
+				out[i] = ::new (p) T(args...);
+			} catch (...) {
+				put(p);
+				throw;
+			}
+		}
+	} catch (...) {
+		destroy_n(out, i);
+		throw;
+	}
+}
+
+template <class T>
+void object_pool<T>::destroy(pointer p)
+{
+	assert(owns(p));
+	p->~T();
+	put(p);
+}
+
+template <class T>
+void object_pool<T>::destroy_n(pointer const *const ps, const size_type n)
+{
+	for (size_type i = 0; i < n; i++) destroy(ps[i]);
+}
+
+template <class T>
+bool object_pool<T>::owns(const void *const p) const
+{
+	const byte *const b = static_cast<const byte *>(p);
+	return b >= start && b < end && (b - start) % slot_size == 0;
+}
+
+template <class T>
+typename object_pool<T>::size_type object_pool<T>::available(void) const
+{
+	return n_free;
+}
+
+template <class T>
+typename object_pool<T>::size_type object_pool<T>::capacity(void) const
+{
+	return static_cast<size_type>(end - start) / slot_size;
+}
+
+template <class T>
+void *const object_pool<T>::memstart(void) const
+{
+	return start;
+}
+
+template <class T>
+void *const object_pool<T>::memend(void) const
+{
+	return end;
+}
+
+template <class T>
+const std::string & object_pool<T>::name(void) const
+{
+	return memname;
+}
+
+template <class T>
+void object_pool<T>::print_free_memory(void) const
+{
+	std::cout << "free memory (" << ((memname.empty()) ? "<unnamed>" : memname) << "): "
+		  << n_free << " of " << capacity() << " slots of " << slot_size << " bytes"
+		  << " at [" << static_cast<void *>(start) << ", " << static_cast<void *>(end) << ")"
+		  << std::endl;
+}
+
+template <class T>
+void *object_pool<T>::take(void)
+{
+	assert(n_free > 0);
+	n_free--;
+	if (free != nullptr) {
+		free_slot *const s = free;
+		free = s->next;
+		return s;
+	}
+	assert(bump < end);
+	void *const p = bump;
+	bump += slot_size;
+	return p;
+}
+
+template <class T>
+void object_pool<T>::put(void *const p)
+{
+	free_slot *const s = ::new (p) free_slot;
+	s->next = free;
+	free = s;
+	n_free++;
+}
+
+} /* namespace StaticMemoryAllocator */
+#endif /* STATIC_MEMORY_ALLOCATOR__OBJECT_POOL_IMPL_H__AD_ */
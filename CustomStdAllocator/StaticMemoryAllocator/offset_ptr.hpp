@@ -0,0 +1,229 @@
+#ifndef STATIC_MEMORY_ALLOCATOR__OFFSET_PTR_H__AD_
+#define STATIC_MEMORY_ALLOCATOR__OFFSET_PTR_H__AD_
+
+/**
+ * \file StaticMemoryAllocator\offset_ptr.hpp
+ * \author Angelos Drossos <angelos.drossos@gmail.com>
+ */
+
+#include <cstdint>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+
+namespace StaticMemoryAllocator {
+
+/**
+ * Pointer, which stores the distance from itself to the pointee
+ * instead of an address.
+ *
+ * As long as the pointer and the pointee are in the same memory block
+ * (e.g. a vector and its elements in a memory mapped file),
+ * the pointer stays valid, wherever the block is mapped.
+ * Copying the pointer recalculates the distance of the copy.
+ *
+ * The distance 1 means nullptr (a pointer cannot point one byte
+ * behind itself, at least not to an object of more than one byte).
+ *
+ * \tparam T Type of the pointee (may be void).
+ */
+template <class T>
+class offset_ptr
+{
+public:
+	typedef T                                             element_type;
+	typedef typename std::remove_cv<T>::type              value_type;
+	typedef std::ptrdiff_t                                difference_type;
+	typedef offset_ptr                                    pointer;
+	typedef typename std::add_lvalue_reference<T>::type   reference;
+	typedef std::random_access_iterator_tag               iterator_category;
+
+	template <class U>
+	struct rebind
+	{
+		typedef offset_ptr<U> other;
+	};
+
+private:
+	/* parameter type of pointer_to(), which cannot be a reference to void */
+	struct nat {};
+	typedef typename std::conditional<std::is_void<T>::value, nat, T>::type & object_reference;
+
+/* constructors, destructors, assignment operators */
+public:
+
+	offset_ptr() throw()
+		: offset(null_offset)
+	{
+	}
+
+	offset_ptr(std::nullptr_t) throw()
+		: offset(null_offset)
+	{
+	}
+
+	offset_ptr(T *const p) throw()
+		: offset(calc_offset(p))
+	{
+	}
+
+	offset_ptr(const offset_ptr & p) throw()
+		: offset(calc_offset(p.get()))
+	{
+	}
+
+	template <class U, class = typename std::enable_if<std::is_convertible<U *, T *>::value>::type>
+	offset_ptr(const offset_ptr<U> & p) throw()
+		: offset(calc_offset(p.get()))
+	{
+	}
+
+	offset_ptr & operator =(const offset_ptr & p) throw()
+	{
+		offset = calc_offset(p.get());
+		return *this;
+	}
+
+	offset_ptr & operator =(T *const p) throw()
+	{
+		offset = calc_offset(p);
+		return *this;
+	}
+
+	static
+	offset_ptr pointer_to(object_reference r) throw()
+	{
+		return offset_ptr(std::addressof(r));
+	}
+
+/* pointer functions */
+public:
+
+	T *get(void) const throw()
+	{
+		if (offset == null_offset) return nullptr;
+		return reinterpret_cast<T *>(reinterpret_cast<uintptr_t>(this) + offset);
+	}
+
+	explicit operator bool(void) const throw()
+	{
+		return offset != null_offset;
+	}
+
+	reference operator *(void) const
+	{
+		return *get();
+	}
+
+	T *operator ->(void) const
+	{
+		return get();
+	}
+
+	reference operator [](const difference_type i) const
+	{
+		return get()[i];
+	}
+
+	offset_ptr & operator ++(void)
+	{
+		offset += sizeof(T);
+		return *this;
+	}
+
+	offset_ptr operator ++(int)
+	{
+		const offset_ptr p(*this);
+		++*this;
+		return p;
+	}
+
+	offset_ptr & operator --(void)
+	{
+		offset -= sizeof(T);
+		return *this;
+	}
+
+	offset_ptr operator --(int)
+	{
+		const offset_ptr p(*this);
+		--*this;
+		return p;
+	}
+
+	offset_ptr & operator +=(const difference_type n)
+	{
+		offset += n * static_cast<difference_type>(sizeof(T));
+		return *this;
+	}
+
+	offset_ptr & operator -=(const difference_type n)
+	{
+		offset -= n * static_cast<difference_type>(sizeof(T));
+		return *this;
+	}
+
+	offset_ptr operator +(const difference_type n) const
+	{
+		return offset_ptr(get() + n);
+	}
+
+	offset_ptr operator -(const difference_type n) const
+	{
+		return offset_ptr(get() - n);
+	}
+
+	friend
+	offset_ptr operator +(const difference_type n, const offset_ptr & p)
+	{
+		return p + n;
+	}
+
+	difference_type operator -(const offset_ptr & p) const
+	{
+		return get() - p.get();
+	}
+
+	bool operator ==(const offset_ptr & p) const { return get() == p.get(); }
+
+	bool operator !=(const offset_ptr & p) const { return get() != p.get(); }
+
+	bool operator <(const offset_ptr & p) const { return get() < p.get(); }
+
+	bool operator <=(const offset_ptr & p) const { return get() <= p.get(); }
+
+	bool operator >(const offset_ptr & p) const { return get() > p.get(); }
+
+	bool operator >=(const offset_ptr & p) const { return get() >= p.get(); }
+
+	friend
+	bool operator ==(const offset_ptr & p, std::nullptr_t) { return !p; }
+
+	friend
+	bool operator ==(std::nullptr_t, const offset_ptr & p) { return !p; }
+
+	friend
+	bool operator !=(const offset_ptr & p, std::nullptr_t) { return static_cast<bool>(p); }
+
+	friend
+	bool operator !=(std::nullptr_t, const offset_ptr & p) { return static_cast<bool>(p); }
+
+private:
+
+	static const difference_type null_offset = 1;
+
+	difference_type calc_offset(const T *const p) const throw()
+	{
+		if (p == nullptr) return null_offset;
+		return static_cast<difference_type>(reinterpret_cast<uintptr_t>(p) - reinterpret_cast<uintptr_t>(this));
+	}
+
+/* member variables */
+private:
+
+	difference_type offset;
+};
+
+} /* namespace StaticMemoryAllocator */
+#endif /* STATIC_MEMORY_ALLOCATOR__OFFSET_PTR_H__AD_ */
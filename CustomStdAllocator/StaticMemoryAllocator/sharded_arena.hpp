@@ -0,0 +1,136 @@
+#ifndef STATIC_MEMORY_ALLOCATOR__SHARDED_ARENA_H__AD_
+#define STATIC_MEMORY_ALLOCATOR__SHARDED_ARENA_H__AD_
+
+/**
+ * \file StaticMemoryAllocator\sharded_arena.hpp
+ * \author Angelos Drossos <angelos.drossos@gmail.com>
+ */
+
+#include "arena.hpp"
+
+#include <memory>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <string>
+
+namespace StaticMemoryAllocator {
+
+/**
+ * Arena, which splits its memory block into shards of the same size,
+ * each managed by an arena (and its bitmap) of its own, thus threads
+ * allocating from different shards do not contend on one bitmap.
+ *
+ * Each thread allocates from its home shard (assigned round-robin to the
+ * threads), if it has no large enough free memory block, the thread steals
+ * from the other shards. A memory block is freed (expanded, shrunk)
+ * by the shard it lies in, which is computed from its address,
+ * thus any thread can free any block.
+ *
+ * A memory block cannot be larger than a shard (see max_size()).
+ *
+ * \tparam Arena Type of the arenas of the shards, which have to be used
+ *         by several threads at the same time (e.g. a concurrent_arena),
+ *         since threads share a shard if there are more threads than shards
+ *         and when they steal.
+ */
+template <class Arena = concurrent_arena<>>
+class sharded_arena
+{
+public:
+	typedef Arena              shard_type;
+	typedef std::size_t        size_type;
+
+	static const size_type granule_size = Arena::granule_size;
+
+/* constructors, destructors, assignment operators */
+public:
+
+	sharded_arena() = delete;
+
+	/**
+	 * Splits the memory block into \p shards shards
+	 * (0: one per core, i.e. std::thread::hardware_concurrency()),
+	 * starting at its first granule (i.e., aligned to granule_size).
+	 */
+	sharded_arena(void *const memstart, const size_type memsize, const std::string & memname = "", size_type shards = 0);
+
+	sharded_arena(const sharded_arena & a) = delete;
+
+	sharded_arena & operator =(const sharded_arena & a) = delete;
+
+/* arena functions */
+public:
+
+	/**
+	 * Reserves a memory block of (at least) \p nb bytes from the home shard
+	 * of the calling thread, or from the next shard with a large enough
+	 * free memory block.
+	 *
+	 * \return Pointer to the memory block, or nullptr if no shard
+	 *         has a large enough (and aligned) free memory block.
+	 */
+	void *allocate(const size_type nb, const size_type alignment, void *const hint = nullptr);
+
+	void deallocate(void *const p, const size_type nb);
+
+	bool expand(void *const p, const size_type old_nb, const size_type new_nb);
+
+	bool shrink(void *const p, const size_type old_nb, const size_type new_nb);
+
+	/**
+	 * Returns the size of the largest free memory block of all shards in bytes.
+	 */
+	size_type max_size(void) const;
+
+	/**
+	 * Returns the size of the managed memory of all shards in bytes.
+	 */
+	size_type size(void) const;
+
+	void *const memstart(void) const;
+
+	void *const memend(void) const;
+
+	const std::string & name(void) const;
+
+	bool operator ==(const sharded_arena & a) const;
+
+	void print_free_memory(void) const;
+
+/* shard functions */
+public:
+
+	size_type shard_count(void) const;
+
+	/**
+	 * Returns the shard \p i (e.g. for its statistics).
+	 */
+	const shard_type & shard(const size_type i) const;
+
+	/**
+	 * Returns the index of the shard, which contains \p p.
+	 */
+	size_type shard_of(const void *const p) const;
+
+	/**
+	 * Returns the index of the home shard of the calling thread.
+	 */
+	size_type home_shard(void) const;
+
+private:
+
+	typedef uint8_t byte;
+
+/* member variables */
+private:
+
+	byte *start;
+	/* size of the memory block of each shard (the last one gets the rest as well) */
+	size_type shard_bytes;
+	std::vector<std::unique_ptr<shard_type>> shards;
+	std::string memname;
+};
+
+} /* namespace StaticMemoryAllocator */
+#endif /* STATIC_MEMORY_ALLOCATOR__SHARDED_ARENA_H__AD_ */
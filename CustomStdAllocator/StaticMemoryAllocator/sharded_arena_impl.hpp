@@ -0,0 +1,155 @@
+#ifndef STATIC_MEMORY_ALLOCATOR__SHARDED_ARENA_IMPL_H__AD_
+#define STATIC_MEMORY_ALLOCATOR__SHARDED_ARENA_IMPL_H__AD_
+
+#include "sharded_arena.hpp"
+#include "arena_impl.hpp"
+
+#include <atomic>
+#include <iostream>
+#include <thread>
+
+#include <assert.h>
+
+namespace StaticMemoryAllocator {
+
+template <class Arena>
+sharded_arena<Arena>::sharded_arena(void *const memstart, const size_type memsize, const std::string & memname, size_type shards)
+	: start(static_cast<byte *>(memstart)
+	        + (Arena::granule_size - reinterpret_cast<uintptr_t>(memstart) % Arena::granule_size) % Arena::granule_size),
+	  shard_bytes(0),
+	  memname(memname)
+{
+	assert(memstart != nullptr);
+	if (shards == 0) shards = std::thread::hardware_concurrency();
+	if (shards == 0) shards = 1;
+	/* the memory in front of the first granule is skipped */
+	const size_type skipped = static_cast<size_type>(start - static_cast<byte *>(memstart));
+	assert(memsize > skipped);
+	const size_type nb_total = memsize - skipped;
+	/* each shard starts at a granule (thus no shard loses memory to its alignment) */
+	shard_bytes = nb_total / shards / Arena::granule_size * Arena::granule_size;
+	assert(shard_bytes > 0);
+	this->shards.reserve(shards);
+	for (size_type i = 0; i < shards; i++) {
+		const size_type nb = (i + 1 < shards) ? shard_bytes : nb_total - i * shard_bytes;
+		this->shards.emplace_back(new shard_type(start + i * shard_bytes, nb, memname));
+	}
+}
+
+template <class Arena>
+void *sharded_arena<Arena>::allocate(const size_type nb, const size_type alignment, void *const hint)
+{
+	assert(nb > 0);
+	const size_type n = shards.size();
+	const size_type home = home_shard();
+	/* a hint into another shard is of no use */
+	const bool local_hint = hint != nullptr && hint >= memstart() && hint < memend() && shard_of(hint) == home;
+	void *p = shards[home]->allocate(nb, alignment, local_hint ? hint : nullptr);
+	for (size_type i = 1; p == nullptr && i < n; i++) {
+		/* steal from the next shards */
+		p = shards[(home + i) % n]->allocate(nb, alignment);
+	}
+	return p;
+}
+
+template <class Arena>
+void sharded_arena<Arena>::deallocate(void *const p, const size_type nb)
+{
+	shards[shard_of(p)]->deallocate(p, nb);
+}
+
+template <class Arena>
+bool sharded_arena<Arena>::expand(void *const p, const size_type old_nb, const size_type new_nb)
+{
+	return shards[shard_of(p)]->expand(p, old_nb, new_nb);
+}
+
+template <class Arena>
+bool sharded_arena<Arena>::shrink(void *const p, const size_type old_nb, const size_type new_nb)
+{
+	return shards[shard_of(p)]->shrink(p, old_nb, new_nb);
+}
+
+template <class Arena>
+typename sharded_arena<Arena>::size_type sharded_arena<Arena>::max_size(void) const
+{
+	size_type largest = 0;
+	for (const auto & s : shards) {
+		const size_type m = s->max_size();
+		if (m > largest) largest = m;
+	}
+	return largest;
+}
+
+template <class Arena>
+typename sharded_arena<Arena>::size_type sharded_arena<Arena>::size(void) const
+{
+	size_type total = 0;
+	for (const auto & s : shards) total += s->size();
+	return total;
+}
+
+template <class Arena>
+void *const sharded_arena<Arena>::memstart(void) const
+{
+	return shards.front()->memstart();
+}
+
+template <class Arena>
+void *const sharded_arena<Arena>::memend(void) const
+{
+	return shards.back()->memend();
+}
+
+template <class Arena>
+const std::string & sharded_arena<Arena>::name(void) const
+{
+	return memname;
+}
+
+template <class Arena>
+bool sharded_arena<Arena>::operator ==(const sharded_arena & a) const
+{
+	return this == &a;
+}
+
+template <class Arena>
+void sharded_arena<Arena>::print_free_memory(void) const
+{
+	for (const auto & s : shards) s->print_free_memory();
+}
+
+template <class Arena>
+typename sharded_arena<Arena>::size_type sharded_arena<Arena>::shard_count(void) const
+{
+	return shards.size();
+}
+
+template <class Arena>
+const typename sharded_arena<Arena>::shard_type & sharded_arena<Arena>::shard(const size_type i) const
+{
+	assert(i < shards.size());
+	return *shards[i];
+}
+
+template <class Arena>
+typename sharded_arena<Arena>::size_type sharded_arena<Arena>::shard_of(const void *const p) const
+{
+	const byte *const b = static_cast<const byte *>(p);
+	assert(b >= start);
+	const size_type i = static_cast<size_type>(b - start) / shard_bytes;
+	/* the last shard is larger by the rest of the memory block */
+	return (i < shards.size()) ? i : shards.size() - 1;
+}
+
+template <class Arena>
+typename sharded_arena<Arena>::size_type sharded_arena<Arena>::home_shard(void) const
+{
+	/* the threads get consecutive numbers, thus they are spread evenly over the shards */
+	static std::atomic<size_type> threads(0);
+	static thread_local const size_type thread_number = threads.fetch_add(1, std::memory_order_relaxed);
+	return thread_number % shards.size();
+}
+
+} /* namespace StaticMemoryAllocator */
+#endif /* STATIC_MEMORY_ALLOCATOR__SHARDED_ARENA_IMPL_H__AD_ */
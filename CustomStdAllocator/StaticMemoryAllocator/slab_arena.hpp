@@ -0,0 +1,154 @@
+#ifndef STATIC_MEMORY_ALLOCATOR__SLAB_ARENA_H__AD_
+#define STATIC_MEMORY_ALLOCATOR__SLAB_ARENA_H__AD_
+
+/**
+ * \file StaticMemoryAllocator\slab_arena.hpp
+ * \author Angelos Drossos <angelos.drossos@gmail.com>
+ */
+
+#include "arena.hpp"
+#include "bitmap.hpp"
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+
+namespace StaticMemoryAllocator {
+
+/**
+ * Arena with slabs of segregated size classes in front of an arena,
+ * e.g. for the nodes of std::list, std::map or std::unordered_map.
+ *
+ * Small blocks (up to \p MaxSize bytes) are served from slabs:
+ * a slab is a block of \p SlabSize bytes (aligned to its size)
+ * allocated from the backing arena, which is split into slots
+ * of one size class (multiples of slot_alignment bytes).
+ * Each slab keeps an intrusive list of its free slots, thus allocating
+ * and freeing a slot is O(1) and does not search the bitmap.
+ * Only allocating a new slab and freeing an empty slab use the backing arena.
+ * All other requests are forwarded to the backing arena.
+ *
+ * The slab headers and free lists are stored inside the slabs,
+ * thus all memory still comes from the managed memory block.
+ * The arena must not be used by several threads at the same time.
+ *
+ * \tparam Arena Type of the backing arena.
+ * \tparam MaxSize Largest block size in bytes, which is served from slabs.
+ * \tparam SlabSize Size of a slab in bytes (a power of two).
+ */
+template <class Arena = bitmap_arena<>, std::size_t MaxSize = 256, std::size_t SlabSize = 4096>
+class slab_arena
+{
+public:
+	typedef Arena              backing_arena_type;
+	typedef std::size_t        size_type;
+
+	static const size_type slot_alignment = 16;
+	static const size_type class_count = (MaxSize + slot_alignment - 1) / slot_alignment;
+
+	static_assert((SlabSize & (SlabSize - 1)) == 0, "the slab size has to be a power of two");
+	static_assert(SlabSize >= 8 * MaxSize, "a slab has to hold at least a few slots of the largest size class");
+
+/* constructors, destructors, assignment operators */
+public:
+
+	slab_arena() = delete;
+
+	slab_arena(void *const memstart, const size_type memsize, const std::string & memname = "");
+
+	slab_arena(const slab_arena & a) = delete;
+
+	slab_arena & operator =(const slab_arena & a) = delete;
+
+/* arena functions */
+public:
+
+	void *allocate(const size_type nb, const size_type alignment, void *const hint = nullptr);
+
+	void deallocate(void *const p, const size_type nb);
+
+	/**
+	 * Grows the memory block at \p p in place: a slot only up to the size
+	 * of its class, other blocks by the backing arena.
+	 */
+	bool expand(void *const p, const size_type old_nb, const size_type new_nb);
+
+	/**
+	 * Shrinks the memory block at \p p in place: a slot keeps its size,
+	 * other blocks are shrunk by the backing arena.
+	 */
+	bool shrink(void *const p, const size_type old_nb, const size_type new_nb);
+
+	/**
+	 * Returns the size of the largest free memory block of the backing arena in bytes
+	 * (free slots in the slabs are not counted).
+	 */
+	size_type max_size(void) const;
+
+	size_type size(void) const;
+
+	void *const memstart(void) const;
+
+	void *const memend(void) const;
+
+	const std::string & name(void) const;
+
+	bool operator ==(const slab_arena & a) const;
+
+	void print_free_memory(void) const;
+
+private:
+
+	typedef uint8_t byte;
+
+	struct free_slot
+	{
+		free_slot *next;
+	};
+
+	/* header at the beginning of each slab */
+	struct slab
+	{
+		/* neighbours in the list of slabs (of the same class) with free slots */
+		slab *prev;
+		slab *next;
+		/* freed slots */
+		free_slot *free;
+		/* the slots from bump to the end of the slab were never used */
+		byte *bump;
+		size_type used;
+		size_type cls;
+	};
+
+	static const size_type header_size = (sizeof(slab) + slot_alignment - 1) / slot_alignment * slot_alignment;
+
+	static
+	size_type calc_class(const size_type nb);
+
+	static
+	size_type class_bytes(const size_type c);
+
+	size_type calc_chunk(const void *const p) const;
+
+	slab *create_slab(const size_type c);
+
+	void release_slab(slab *const s);
+
+	void link(slab *const s);
+
+	void unlink(slab *const s);
+
+/* member variables */
+private:
+
+	Arena arena;
+	/* first address of the (SlabSize aligned) chunks of the managed memory block */
+	byte *chunks;
+	/* one bit per chunk: set, if the chunk is a slab */
+	bitmap slabs;
+	/* slabs with free slots, per size class */
+	slab *partial[class_count];
+};
+
+} /* namespace StaticMemoryAllocator */
+#endif /* STATIC_MEMORY_ALLOCATOR__SLAB_ARENA_H__AD_ */
@@ -0,0 +1,201 @@
+#ifndef STATIC_MEMORY_ALLOCATOR__SLAB_ARENA_IMPL_H__AD_
+#define STATIC_MEMORY_ALLOCATOR__SLAB_ARENA_IMPL_H__AD_
+
+#include "slab_arena.hpp"
+#include "arena_impl.hpp"
+
+#include <algorithm>
+
+#include <assert.h>
+
+namespace StaticMemoryAllocator {
+
+template <class Arena, std::size_t MaxSize, std::size_t SlabSize>
+slab_arena<Arena, MaxSize, SlabSize>::slab_arena(void *const memstart, const size_type memsize, const std::string & memname)
+	: arena(memstart, memsize, memname),
+	  chunks(reinterpret_cast<byte *>(reinterpret_cast<uintptr_t>(arena.memstart()) & ~static_cast<uintptr_t>(SlabSize - 1))),
+	  slabs((static_cast<byte *>(arena.memend()) - chunks + SlabSize - 1) / SlabSize, false)
+{
+	std::fill(partial, partial + class_count, nullptr);
+}
+
+template <class Arena, std::size_t MaxSize, std::size_t SlabSize>
+void *slab_arena<Arena, MaxSize, SlabSize>::allocate(const size_type nb, const size_type alignment, void *const hint)
+{
+	assert(nb > 0);
+	if (nb > MaxSize || alignment > slot_alignment) {
+		return arena.allocate(nb, alignment, hint);
+	}
+	const size_type c = calc_class(nb);
+	slab *s = partial[c];
+	if (s == nullptr) {
+		s = create_slab(c);
+		if (s == nullptr) return nullptr;
+	}
+	void *p;
+	if (s->free != nullptr) {
+		p = s->free;
+		s->free = s->free->next;
+	} else {
+		p = s->bump;
+		s->bump += class_bytes(c);
+	}
+	s->used++;
+	/* the slab is full now */
+	if (s->free == nullptr && s->bump + class_bytes(c) > reinterpret_cast<byte *>(s) + SlabSize) {
+		unlink(s);
+	}
+	return p;
+}
+
+template <class Arena, std::size_t MaxSize, std::size_t SlabSize>
+void slab_arena<Arena, MaxSize, SlabSize>::deallocate(void *const p, const size_type nb)
+{
+	assert(nb > 0);
+	if (!slabs.test(calc_chunk(p))) {
+		arena.deallocate(p, nb);
+		return;
+	}
+	slab *const s = reinterpret_cast<slab *>(chunks + calc_chunk(p) * SlabSize);
+	assert(nb <= class_bytes(s->cls));
+	const bool full = s->free == nullptr && s->bump + class_bytes(s->cls) > reinterpret_cast<byte *>(s) + SlabSize;
+	free_slot *const slot = static_cast<free_slot *>(p);
+	slot->next = s->free;
+	s->free = slot;
+	s->used--;
+	if (full) link(s);
+	/* an empty slab is kept, if it is the only one of its class (to avoid creating it again and again) */
+	if (s->used == 0 && (partial[s->cls] != s || s->next != nullptr)) release_slab(s);
+}
+
+template <class Arena, std::size_t MaxSize, std::size_t SlabSize>
+bool slab_arena<Arena, MaxSize, SlabSize>::expand(void *const p, const size_type old_nb, const size_type new_nb)
+{
+	assert(old_nb > 0 && new_nb > 0);
+	if (!slabs.test(calc_chunk(p))) return arena.expand(p, old_nb, new_nb);
+	const slab *const s = reinterpret_cast<const slab *>(chunks + calc_chunk(p) * SlabSize);
+	return new_nb <= class_bytes(s->cls);
+}
+
+template <class Arena, std::size_t MaxSize, std::size_t SlabSize>
+bool slab_arena<Arena, MaxSize, SlabSize>::shrink(void *const p, const size_type old_nb, const size_type new_nb)
+{
+	assert(old_nb > 0 && new_nb > 0);
+	if (!slabs.test(calc_chunk(p))) return arena.shrink(p, old_nb, new_nb);
+	return true;
+}
+
+template <class Arena, std::size_t MaxSize, std::size_t SlabSize>
+typename slab_arena<Arena, MaxSize, SlabSize>::size_type slab_arena<Arena, MaxSize, SlabSize>::max_size(void) const
+{
+	return arena.max_size();
+}
+
+template <class Arena, std::size_t MaxSize, std::size_t SlabSize>
+typename slab_arena<Arena, MaxSize, SlabSize>::size_type slab_arena<Arena, MaxSize, SlabSize>::size(void) const
+{
+	return arena.size();
+}
+
+template <class Arena, std::size_t MaxSize, std::size_t SlabSize>
+void *const slab_arena<Arena, MaxSize, SlabSize>::memstart(void) const
+{
+	return arena.memstart();
+}
+
+template <class Arena, std::size_t MaxSize, std::size_t SlabSize>
+void *const slab_arena<Arena, MaxSize, SlabSize>::memend(void) const
+{
+	return arena.memend();
+}
+
+template <class Arena, std::size_t MaxSize, std::size_t SlabSize>
+const std::string & slab_arena<Arena, MaxSize, SlabSize>::name(void) const
+{
+	return arena.name();
+}
+
+template <class Arena, std::size_t MaxSize, std::size_t SlabSize>
+bool slab_arena<Arena, MaxSize, SlabSize>::operator ==(const slab_arena & a) const
+{
+	return arena == a.arena;
+}
+
+template <class Arena, std::size_t MaxSize, std::size_t SlabSize>
+void slab_arena<Arena, MaxSize, SlabSize>::print_free_memory(void) const
+{
+	arena.print_free_memory();
+}
+
+template <class Arena, std::size_t MaxSize, std::size_t SlabSize>
+typename slab_arena<Arena, MaxSize, SlabSize>::size_type slab_arena<Arena, MaxSize, SlabSize>::calc_class(const size_type nb)
+{
+	assert(nb > 0 && nb <= MaxSize);
+	return (nb - 1) / slot_alignment;
+}
+
+template <class Arena, std::size_t MaxSize, std::size_t SlabSize>
+typename slab_arena<Arena, MaxSize, SlabSize>::size_type slab_arena<Arena, MaxSize, SlabSize>::class_bytes(const size_type c)
+{
+	return (c + 1) * slot_alignment;
+}
+
+template <class Arena, std::size_t MaxSize, std::size_t SlabSize>
+typename slab_arena<Arena, MaxSize, SlabSize>::size_type slab_arena<Arena, MaxSize, SlabSize>::calc_chunk(const void *const p) const
+{
+	const byte *const b = static_cast<const byte *>(p);
+	assert(b >= chunks && b < static_cast<byte *>(arena.memend()));
+	return static_cast<size_type>(b - chunks) / SlabSize;
+}
+
+template <class Arena, std::size_t MaxSize, std::size_t SlabSize>
+typename slab_arena<Arena, MaxSize, SlabSize>::slab *slab_arena<Arena, MaxSize, SlabSize>::create_slab(const size_type c)
+{
+	void *const mem = arena.allocate(SlabSize, SlabSize);
+	if (mem == nullptr) return nullptr;
+	slab *const s = static_cast<slab *>(mem);
+	s->prev = nullptr;
+	s->next = nullptr;
+	s->free = nullptr;
+	s->bump = static_cast<byte *>(mem) + header_size;
+	s->used = 0;
+	s->cls = c;
+	slabs.set(calc_chunk(s), 1);
+	link(s);
+	return s;
+}
+
+template <class Arena, std::size_t MaxSize, std::size_t SlabSize>
+void slab_arena<Arena, MaxSize, SlabSize>::release_slab(slab *const s)
+{
+	assert(s->used == 0);
+	unlink(s);
+	slabs.reset(calc_chunk(s), 1);
+	arena.deallocate(s, SlabSize);
+}
+
+template <class Arena, std::size_t MaxSize, std::size_t SlabSize>
+void slab_arena<Arena, MaxSize, SlabSize>::link(slab *const s)
+{
+	s->prev = nullptr;
+	s->next = partial[s->cls];
+	if (s->next != nullptr) s->next->prev = s;
+	partial[s->cls] = s;
+}
+
+template <class Arena, std::size_t MaxSize, std::size_t SlabSize>
+void slab_arena<Arena, MaxSize, SlabSize>::unlink(slab *const s)
+{
+	if (s->prev != nullptr) {
+		s->prev->next = s->next;
+	} else {
+		assert(partial[s->cls] == s);
+		partial[s->cls] = s->next;
+	}
+	if (s->next != nullptr) s->next->prev = s->prev;
+	s->prev = nullptr;
+	s->next = nullptr;
+}
+
+} /* namespace StaticMemoryAllocator */
+#endif /* STATIC_MEMORY_ALLOCATOR__SLAB_ARENA_IMPL_H__AD_ */
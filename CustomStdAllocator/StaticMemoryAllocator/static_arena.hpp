@@ -0,0 +1,133 @@
+#ifndef STATIC_MEMORY_ALLOCATOR__STATIC_ARENA_H__AD_
+#define STATIC_MEMORY_ALLOCATOR__STATIC_ARENA_H__AD_
+
+/**
+ * \file StaticMemoryAllocator\static_arena.hpp
+ * \author Angelos Drossos <angelos.drossos@gmail.com>
+ */
+
+#include "bitops.hpp"
+
+#include <array>
+#include <cstdint>
+#include <cstddef>
+#include <string>
+
+namespace StaticMemoryAllocator {
+
+/**
+ * Arena of a fixed size, which contains its memory block of \p N bytes
+ * and its bitmap (one bit per granule of \p Granule bytes) itself.
+ *
+ * Since all sizes are known at compile time, the arena does not allocate
+ * any memory on the heap (its name is stored in the arena as well),
+ * e.g. to be used as a global or static object. Allocators use it by
+ * allocator(arena_type &), thus it has to outlive all of its allocators.
+ *
+ * \tparam N Size of the memory block in bytes (a multiple of \p Granule).
+ * \tparam Granule Size of a granule in bytes (a power of two),
+ *         the memory block is aligned to it.
+ */
+template <std::size_t N, std::size_t Granule = 16>
+class static_arena
+{
+	static_assert(Granule > 0 && (Granule & (Granule - 1)) == 0,
+	              "the granule size has to be a power of two");
+	static_assert(N > 0 && N % Granule == 0,
+	              "the size of the memory block has to be a multiple of the granule size");
+
+public:
+	typedef std::size_t        size_type;
+
+	static const size_type granule_size = Granule;
+	static const size_type granule_count = N / Granule;
+
+	/**
+	 * Maximal length of the name (a longer name is truncated).
+	 */
+	static const size_type name_capacity = 64;
+
+/* constructors, destructors, assignment operators */
+public:
+
+	explicit static_arena(const char *const memname = "");
+
+	static_arena(const static_arena & a) = delete;
+
+	static_arena & operator =(const static_arena & a) = delete;
+
+/* arena functions */
+public:
+
+	/**
+	 * Reserves a memory block of (at least) \p nb bytes.
+	 *
+	 * \param nb Size of the memory block in bytes.
+	 * \param alignment Alignment of the memory block (a power of two).
+	 * \param hint Not used.
+	 * \return Pointer to the memory block, or nullptr if there is no
+	 *         large enough (and aligned) free memory block.
+	 */
+	void *allocate(const size_type nb, const size_type alignment, void *const hint = nullptr);
+
+	void deallocate(void *const p, const size_type nb);
+
+	bool expand(void *const p, const size_type old_nb, const size_type new_nb);
+
+	bool shrink(void *const p, const size_type old_nb, const size_type new_nb);
+
+	/**
+	 * Returns the size of the largest free memory block in bytes.
+	 */
+	size_type max_size(void) const;
+
+	size_type size(void) const;
+
+	void *const memstart(void) const;
+
+	void *const memend(void) const;
+
+	/**
+	 * Returns the name (which is stored in the arena, thus by value).
+	 */
+	std::string name(void) const;
+
+	bool operator ==(const static_arena & a) const;
+
+	void print_free_memory(void) const;
+
+private:
+
+	typedef uint8_t byte;
+	typedef bitops::word_type word_type;
+
+	static const size_type bits_per_word = bitops::bits_per_word;
+	static const size_type word_count = (granule_count + bits_per_word - 1) / bits_per_word;
+
+	static
+	size_type calc_granules(const size_type nb);
+
+	size_type calc_pos(const void *const p) const;
+
+	bool test(const size_type pos) const;
+
+	bool all(const size_type pos, const size_type n) const;
+
+	void assign(const size_type pos, const size_type n, const bool value);
+
+	/* first set (value) or cleared (!value) bit in [pos, granule_count) */
+	size_type find(const size_type pos, const bool value) const;
+
+	size_type find_free_memory(const size_type ng, const size_type alignment) const;
+
+/* member variables */
+private:
+
+	alignas(Granule) byte mem[N];
+	/* one bit per granule: set, if the granule is free */
+	std::array<word_type, word_count> memfree;
+	char memname[name_capacity];
+};
+
+} /* namespace StaticMemoryAllocator */
+#endif /* STATIC_MEMORY_ALLOCATOR__STATIC_ARENA_H__AD_ */
@@ -0,0 +1,188 @@
+#ifndef STATIC_MEMORY_ALLOCATOR__STATIC_ARENA_IMPL_H__AD_
+#define STATIC_MEMORY_ALLOCATOR__STATIC_ARENA_IMPL_H__AD_
+
+#include "static_arena.hpp"
+
+#include <iostream>
+#include <cstring>
+
+#include <assert.h>
+
+namespace StaticMemoryAllocator {
+
+template <std::size_t N, std::size_t Granule>
+static_arena<N, Granule>::static_arena(const char *const memname)
+{
+	assert(memname != nullptr);
+	std::strncpy(this->memname, memname, name_capacity - 1);
+	this->memname[name_capacity - 1] = '\0';
+	memfree.fill(bitops::all_ones);
+	/* bits behind granule_count are always cleared (i.e., never free) */
+	if (granule_count % bits_per_word != 0) {
+		memfree[word_count - 1] = bitops::range_mask(0, granule_count % bits_per_word);
+	}
+}
+
+template <std::size_t N, std::size_t Granule>
+void *static_arena<N, Granule>::allocate(const size_type nb, const size_type alignment, void *const hint)
+{
+	assert(nb > 0);
+	assert(alignment > 0 && (alignment & (alignment - 1)) == 0);
+	(void) hint;
+	if (nb > N) return nullptr;
+	const size_type ng = calc_granules(nb);
+	const size_type pos = find_free_memory(ng, alignment);
+	if (pos >= granule_count) return nullptr;
+	assign(pos, ng, false);
+	return &mem[pos * Granule];
+}
+
+template <std::size_t N, std::size_t Granule>
+void static_arena<N, Granule>::deallocate(void *const p, const size_type nb)
+{
+	assert(nb > 0);
+	const size_type pos = calc_pos(p);
+	const size_type ng = calc_granules(nb);
+	assert(pos + ng <= granule_count);
+	assert(find(pos, true) >= pos + ng);
+	assign(pos, ng, true);
+}
+
+template <std::size_t N, std::size_t Granule>
+bool static_arena<N, Granule>::expand(void *const p, const size_type old_nb, const size_type new_nb)
+{
+	assert(old_nb > 0 && new_nb > 0);
+	if (new_nb > N) return false;
+	const size_type old_ng = calc_granules(old_nb);
+	const size_type new_ng = calc_granules(new_nb);
+	if (new_ng <= old_ng) return true;
+	const size_type pos = calc_pos(p);
+	if (pos + new_ng > granule_count || !all(pos + old_ng, new_ng - old_ng)) return false;
+	assign(pos + old_ng, new_ng - old_ng, false);
+	return true;
+}
+
+template <std::size_t N, std::size_t Granule>
+bool static_arena<N, Granule>::shrink(void *const p, const size_type old_nb, const size_type new_nb)
+{
+	assert(old_nb > 0 && new_nb > 0);
+	const size_type old_ng = calc_granules(old_nb);
+	const size_type new_ng = calc_granules(new_nb);
+	if (new_ng < old_ng) assign(calc_pos(p) + new_ng, old_ng - new_ng, true);
+	return true;
+}
+
+template <std::size_t N, std::size_t Granule>
+typename static_arena<N, Granule>::size_type static_arena<N, Granule>::max_size(void) const
+{
+	size_type longest = 0;
+	for (size_type pos = find(0, true); pos < granule_count; ) {
+		const size_type last = find(pos, false);
+		if (last - pos > longest) longest = last - pos;
+		pos = find(last, true);
+	}
+	return longest * Granule;
+}
+
+template <std::size_t N, std::size_t Granule>
+typename static_arena<N, Granule>::size_type static_arena<N, Granule>::size(void) const
+{
+	return N;
+}
+
+template <std::size_t N, std::size_t Granule>
+void *const static_arena<N, Granule>::memstart(void) const
+{
+	return const_cast<byte *>(&mem[0]);
+}
+
+template <std::size_t N, std::size_t Granule>
+void *const static_arena<N, Granule>::memend(void) const
+{
+	return const_cast<byte *>(&mem[0]) + N;
+}
+
+template <std::size_t N, std::size_t Granule>
+std::string static_arena<N, Granule>::name(void) const
+{
+	return std::string(memname);
+}
+
+template <std::size_t N, std::size_t Granule>
+bool static_arena<N, Granule>::operator ==(const static_arena & a) const
+{
+	return this == &a;
+}
+
+template <std::size_t N, std::size_t Granule>
+void static_arena<N, Granule>::print_free_memory(void) const
+{
+	std::cout << "free memory (" << ((memname[0] == '\0') ? "<unnamed>" : memname) << "): ";
+	for (size_type pos = granule_count; pos > 0; pos--) {
+		std::cout << (test(pos - 1) ? '1' : '0');
+	}
+	std::cout << " at (" << memend() << ", " << memstart() << "]" << std::endl;
+}
+
+template <std::size_t N, std::size_t Granule>
+typename static_arena<N, Granule>::size_type static_arena<N, Granule>::calc_granules(const size_type nb)
+{
+	return (nb + Granule - 1) / Granule;
+}
+
+template <std::size_t N, std::size_t Granule>
+typename static_arena<N, Granule>::size_type static_arena<N, Granule>::calc_pos(const void *const p) const
+{
+	const byte *const b = static_cast<const byte *>(p);
+	assert(b >= &mem[0] && b < &mem[0] + N);
+	assert((b - &mem[0]) % Granule == 0);
+	return static_cast<size_type>(b - &mem[0]) / Granule;
+}
+
+template <std::size_t N, std::size_t Granule>
+bool static_arena<N, Granule>::test(const size_type pos) const
+{
+	assert(pos < granule_count);
+	return (memfree[pos / bits_per_word] >> (pos % bits_per_word)) & 1;
+}
+
+template <std::size_t N, std::size_t Granule>
+bool static_arena<N, Granule>::all(const size_type pos, const size_type n) const
+{
+	return find(pos, false) >= pos + n;
+}
+
+template <std::size_t N, std::size_t Granule>
+void static_arena<N, Granule>::assign(const size_type pos, const size_type n, const bool value)
+{
+	assert(pos + n <= granule_count);
+	bitops::assign(memfree.data(), pos, n, value);
+}
+
+template <std::size_t N, std::size_t Granule>
+typename static_arena<N, Granule>::size_type static_arena<N, Granule>::find(const size_type pos, const bool value) const
+{
+	return bitops::find(memfree.data(), granule_count, pos, value);
+}
+
+template <std::size_t N, std::size_t Granule>
+typename static_arena<N, Granule>::size_type static_arena<N, Granule>::find_free_memory(const size_type ng, const size_type alignment) const
+{
+	/* the memory block is aligned to the granule size, for larger alignments only each stride-th granule is aligned */
+	const size_type stride = (alignment > Granule) ? alignment / Granule : 1;
+	const size_type offset = (stride > 1)
+		? ((alignment - reinterpret_cast<uintptr_t>(&mem[0]) % alignment) % alignment) / Granule
+		: 0;
+	for (size_type pos = find(0, true); pos < granule_count; ) {
+		const size_type aligned = pos + (offset + stride - pos % stride) % stride;
+		if (aligned + ng > granule_count) break;
+		/* the end of the free run matters only up to the end of the block */
+		const size_type last = bitops::find(memfree.data(), aligned + ng, pos, false);
+		if (aligned + ng <= last) return aligned;
+		pos = find(last, true);
+	}
+	return granule_count;
+}
+
+} /* namespace StaticMemoryAllocator */
+#endif /* STATIC_MEMORY_ALLOCATOR__STATIC_ARENA_IMPL_H__AD_ */
@@ -0,0 +1,141 @@
+#ifndef STATIC_MEMORY_ALLOCATOR__THREAD_CACHED_ARENA_H__AD_
+#define STATIC_MEMORY_ALLOCATOR__THREAD_CACHED_ARENA_H__AD_
+
+/**
+ * \file StaticMemoryAllocator\thread_cached_arena.hpp
+ * \author Angelos Drossos <angelos.drossos@gmail.com>
+ */
+
+#include "arena.hpp"
+
+#include <memory>
+#include <mutex>
+#include <cstdint>
+#include <cstddef>
+#include <string>
+
+namespace StaticMemoryAllocator {
+
+/**
+ * Arena with a cache per thread in front of a shared arena.
+ *
+ * Small blocks (up to \p MaxSize bytes) are served from size classes
+ * (multiples of class_size bytes) of the cache of the calling thread.
+ * An empty size class is refilled by one allocation of \p BatchSize blocks
+ * from the shared arena, freed blocks go back to the cache of the
+ * freeing thread first. If a size class holds more than 2 * \p BatchSize
+ * blocks, \p BatchSize of them are returned to the shared arena at once
+ * (neighbouring blocks are merged before).
+ * A thread returns all cached blocks when it exits (or calls flush()).
+ *
+ * The free lists are stored inside the free blocks,
+ * thus all memory still comes from the managed memory block.
+ *
+ * \tparam Arena Type of the shared arena, which has to allow freeing
+ *         parts of an allocated block (e.g. a concurrent_arena).
+ * \tparam MaxSize Largest block size in bytes, which is cached.
+ * \tparam BatchSize Number of blocks allocated at once to refill a size class.
+ */
+template <class Arena = concurrent_arena<>, std::size_t MaxSize = 256, std::size_t BatchSize = 32>
+class thread_cached_arena
+{
+public:
+	typedef Arena              backing_arena_type;
+	typedef std::size_t        size_type;
+
+	static const size_type class_size = (Arena::granule_size > 16) ? Arena::granule_size : 16;
+	static const size_type class_count = (MaxSize + class_size - 1) / class_size;
+
+	static_assert(BatchSize > 0, "at least one block has to be cached per batch");
+
+/* constructors, destructors, assignment operators */
+public:
+
+	thread_cached_arena() = delete;
+
+	thread_cached_arena(void *const memstart, const size_type memsize, const std::string & memname = "");
+
+	thread_cached_arena(const thread_cached_arena & a) = delete;
+
+	~thread_cached_arena();
+
+	thread_cached_arena & operator =(const thread_cached_arena & a) = delete;
+
+/* arena functions */
+public:
+
+	void *allocate(const size_type nb, const size_type alignment, void *const hint = nullptr);
+
+	void deallocate(void *const p, const size_type nb);
+
+	/**
+	 * Grows the memory block at \p p in place: a cached block only up to
+	 * the size of its class, other blocks by the shared arena.
+	 */
+	bool expand(void *const p, const size_type old_nb, const size_type new_nb);
+
+	/**
+	 * Shrinks the memory block at \p p in place: a cached block only within
+	 * its class, other blocks by the shared arena, as long as they are not cached.
+	 */
+	bool shrink(void *const p, const size_type old_nb, const size_type new_nb);
+
+	/**
+	 * Returns the size of the largest free memory block of the shared arena in bytes
+	 * (the blocks in the caches of the threads are not counted).
+	 */
+	size_type max_size(void) const;
+
+	size_type size(void) const;
+
+	void *const memstart(void) const;
+
+	void *const memend(void) const;
+
+	const std::string & name(void) const;
+
+	bool operator ==(const thread_cached_arena & a) const;
+
+	void print_free_memory(void) const;
+
+	/**
+	 * Returns all blocks cached by the calling thread to the shared arena.
+	 */
+	void flush(void);
+
+private:
+
+	struct free_block
+	{
+		free_block *next;
+	};
+
+	struct shared_state;
+
+	struct cache;
+
+	struct thread_caches;
+
+	static
+	size_type calc_class(const size_type nb);
+
+	static
+	size_type class_bytes(const size_type c);
+
+	cache & local_cache(void);
+
+	bool refill(cache & local, const size_type c);
+
+	void spill(cache & local, const size_type c, size_type count);
+
+	void spill_all(cache & local);
+
+/* member variables */
+private:
+
+	Arena arena;
+	std::shared_ptr<shared_state> state;
+};
+
+} /* namespace StaticMemoryAllocator */
+#endif /* STATIC_MEMORY_ALLOCATOR__THREAD_CACHED_ARENA_H__AD_ */
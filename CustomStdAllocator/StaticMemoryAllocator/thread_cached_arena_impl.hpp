@@ -0,0 +1,284 @@
+#ifndef STATIC_MEMORY_ALLOCATOR__THREAD_CACHED_ARENA_IMPL_H__AD_
+#define STATIC_MEMORY_ALLOCATOR__THREAD_CACHED_ARENA_IMPL_H__AD_
+
+#include "thread_cached_arena.hpp"
+#include "arena_impl.hpp"
+
+#include <algorithm>
+#include <vector>
+
+#include <assert.h>
+
+namespace StaticMemoryAllocator {
+
+/* state shared by an arena and the caches of all threads using it */
+template <class Arena, std::size_t MaxSize, std::size_t BatchSize>
+struct thread_cached_arena<Arena, MaxSize, BatchSize>::shared_state
+{
+	std::mutex mutex;
+	/* nullptr, after the arena was destroyed */
+	thread_cached_arena *owner;
+};
+
+/* cache of one thread for one arena */
+template <class Arena, std::size_t MaxSize, std::size_t BatchSize>
+struct thread_cached_arena<Arena, MaxSize, BatchSize>::cache
+{
+	explicit cache(const std::shared_ptr<shared_state> & state)
+		: state(state)
+	{
+		std::fill(lists, lists + class_count, nullptr);
+		std::fill(counts, counts + class_count, 0);
+	}
+
+	std::shared_ptr<shared_state> state;
+	free_block *lists[class_count];
+	size_type counts[class_count];
+};
+
+/* all caches of one thread, returned to their arenas when the thread exits */
+template <class Arena, std::size_t MaxSize, std::size_t BatchSize>
+struct thread_cached_arena<Arena, MaxSize, BatchSize>::thread_caches
+{
+	thread_caches() : last(nullptr) {}
+
+	~thread_caches()
+	{
+		for (auto & c : caches) {
+			std::lock_guard<std::mutex> lock(c->state->mutex);
+			if (c->state->owner != nullptr) c->state->owner->spill_all(*c);
+		}
+	}
+
+	std::vector<std::unique_ptr<cache>> caches;
+	/* the cache found last (most threads use one arena at a time) */
+	cache *last;
+};
+
+template <class Arena, std::size_t MaxSize, std::size_t BatchSize>
+thread_cached_arena<Arena, MaxSize, BatchSize>::thread_cached_arena(void *const memstart, const size_type memsize, const std::string & memname)
+	: arena(memstart, memsize, memname),
+	  state(std::make_shared<shared_state>())
+{
+	state->owner = this;
+}
+
+template <class Arena, std::size_t MaxSize, std::size_t BatchSize>
+thread_cached_arena<Arena, MaxSize, BatchSize>::~thread_cached_arena()
+{
+	/* the caches of the threads must not return their blocks anymore */
+	std::lock_guard<std::mutex> lock(state->mutex);
+	state->owner = nullptr;
+}
+
+template <class Arena, std::size_t MaxSize, std::size_t BatchSize>
+void *thread_cached_arena<Arena, MaxSize, BatchSize>::allocate(const size_type nb, const size_type alignment, void *const hint)
+{
+	assert(nb > 0);
+	if (nb > MaxSize || alignment > class_size) {
+		/* small over-aligned blocks get the size of their class, since they are cached when freed */
+		return arena.allocate((nb <= MaxSize) ? class_bytes(calc_class(nb)) : nb, alignment, hint);
+	}
+	const size_type c = calc_class(nb);
+	cache & local = local_cache();
+	if (local.lists[c] == nullptr && !refill(local, c)) {
+		/* return the blocks of all other size classes and try again */
+		spill_all(local);
+		if (!refill(local, c)) return nullptr;
+	}
+	free_block *const b = local.lists[c];
+	local.lists[c] = b->next;
+	local.counts[c]--;
+	return b;
+}
+
+template <class Arena, std::size_t MaxSize, std::size_t BatchSize>
+void thread_cached_arena<Arena, MaxSize, BatchSize>::deallocate(void *const p, const size_type nb)
+{
+	assert(nb > 0);
+	assert(p >= arena.memstart() && p < arena.memend());
+	if (nb > MaxSize) {
+		arena.deallocate(p, nb);
+		return;
+	}
+	const size_type c = calc_class(nb);
+	cache & local = local_cache();
+	free_block *const b = static_cast<free_block *>(p);
+	b->next = local.lists[c];
+	local.lists[c] = b;
+	if (++local.counts[c] > 2 * BatchSize) spill(local, c, BatchSize);
+}
+
+template <class Arena, std::size_t MaxSize, std::size_t BatchSize>
+bool thread_cached_arena<Arena, MaxSize, BatchSize>::expand(void *const p, const size_type old_nb, const size_type new_nb)
+{
+	assert(old_nb > 0 && new_nb > 0);
+	/* a block is freed by its size, thus a cached block has to stay in its class */
+	if (old_nb <= MaxSize) return new_nb <= class_bytes(calc_class(old_nb));
+	return arena.expand(p, old_nb, new_nb);
+}
+
+template <class Arena, std::size_t MaxSize, std::size_t BatchSize>
+bool thread_cached_arena<Arena, MaxSize, BatchSize>::shrink(void *const p, const size_type old_nb, const size_type new_nb)
+{
+	assert(old_nb > 0 && new_nb > 0);
+	if (old_nb <= MaxSize) return calc_class(new_nb) == calc_class(old_nb);
+	if (new_nb <= MaxSize) return false;
+	return arena.shrink(p, old_nb, new_nb);
+}
+
+template <class Arena, std::size_t MaxSize, std::size_t BatchSize>
+typename thread_cached_arena<Arena, MaxSize, BatchSize>::size_type thread_cached_arena<Arena, MaxSize, BatchSize>::max_size(void) const
+{
+	return arena.max_size();
+}
+
+template <class Arena, std::size_t MaxSize, std::size_t BatchSize>
+typename thread_cached_arena<Arena, MaxSize, BatchSize>::size_type thread_cached_arena<Arena, MaxSize, BatchSize>::size(void) const
+{
+	return arena.size();
+}
+
+template <class Arena, std::size_t MaxSize, std::size_t BatchSize>
+void *const thread_cached_arena<Arena, MaxSize, BatchSize>::memstart(void) const
+{
+	return arena.memstart();
+}
+
+template <class Arena, std::size_t MaxSize, std::size_t BatchSize>
+void *const thread_cached_arena<Arena, MaxSize, BatchSize>::memend(void) const
+{
+	return arena.memend();
+}
+
+template <class Arena, std::size_t MaxSize, std::size_t BatchSize>
+const std::string & thread_cached_arena<Arena, MaxSize, BatchSize>::name(void) const
+{
+	return arena.name();
+}
+
+template <class Arena, std::size_t MaxSize, std::size_t BatchSize>
+bool thread_cached_arena<Arena, MaxSize, BatchSize>::operator ==(const thread_cached_arena & a) const
+{
+	return arena == a.arena;
+}
+
+template <class Arena, std::size_t MaxSize, std::size_t BatchSize>
+void thread_cached_arena<Arena, MaxSize, BatchSize>::print_free_memory(void) const
+{
+	arena.print_free_memory();
+}
+
+template <class Arena, std::size_t MaxSize, std::size_t BatchSize>
+void thread_cached_arena<Arena, MaxSize, BatchSize>::flush(void)
+{
+	spill_all(local_cache());
+}
+
+template <class Arena, std::size_t MaxSize, std::size_t BatchSize>
+typename thread_cached_arena<Arena, MaxSize, BatchSize>::size_type thread_cached_arena<Arena, MaxSize, BatchSize>::calc_class(const size_type nb)
+{
+	assert(nb > 0 && nb <= MaxSize);
+	return (nb - 1) / class_size;
+}
+
+template <class Arena, std::size_t MaxSize, std::size_t BatchSize>
+typename thread_cached_arena<Arena, MaxSize, BatchSize>::size_type thread_cached_arena<Arena, MaxSize, BatchSize>::class_bytes(const size_type c)
+{
+	return (c + 1) * class_size;
+}
+
+template <class Arena, std::size_t MaxSize, std::size_t BatchSize>
+typename thread_cached_arena<Arena, MaxSize, BatchSize>::cache & thread_cached_arena<Arena, MaxSize, BatchSize>::local_cache(void)
+{
+	static thread_local thread_caches local;
+	if (local.last != nullptr && local.last->state == state) return *local.last;
+	cache *found = nullptr;
+	for (auto i = local.caches.begin(); i != local.caches.end(); ) {
+		if ((*i)->state == state) {
+			found = (i++)->get();
+			continue;
+		}
+		bool destroyed;
+		{
+			std::lock_guard<std::mutex> lock((*i)->state->mutex);
+			destroyed = (*i)->state->owner == nullptr;
+		}
+		/* the blocks of a destroyed arena are gone with its memory block */
+		if (destroyed) {
+			i = local.caches.erase(i);
+		} else {
+			++i;
+		}
+	}
+	if (found == nullptr) {
+		local.caches.emplace_back(new cache(state));
+		found = local.caches.back().get();
+	}
+	local.last = found;
+	return *found;
+}
+
+template <class Arena, std::size_t MaxSize, std::size_t BatchSize>
+bool thread_cached_arena<Arena, MaxSize, BatchSize>::refill(cache & local, const size_type c)
+{
+	assert(local.lists[c] == nullptr);
+	typedef uint8_t byte;
+	const size_type nb = class_bytes(c);
+	/* one batch of blocks at once, or less, if there is no such large free memory block */
+	for (size_type n = BatchSize; n > 0; n /= 2) {
+		byte *const chunk = static_cast<byte *>(arena.allocate(n * nb, class_size));
+		if (chunk == nullptr) continue;
+		for (size_type i = n; i > 0; i--) {
+			free_block *const b = reinterpret_cast<free_block *>(chunk + (i - 1) * nb);
+			b->next = local.lists[c];
+			local.lists[c] = b;
+		}
+		local.counts[c] += n;
+		return true;
+	}
+	return false;
+}
+
+template <class Arena, std::size_t MaxSize, std::size_t BatchSize>
+void thread_cached_arena<Arena, MaxSize, BatchSize>::spill(cache & local, const size_type c, size_type count)
+{
+	typedef uint8_t byte;
+	const size_type nb = class_bytes(c);
+	byte *blocks[BatchSize];
+	assert(count <= local.counts[c]);
+	while (count > 0) {
+		const size_type n = std::min(count, BatchSize);
+		for (size_type i = 0; i < n; i++) {
+			blocks[i] = reinterpret_cast<byte *>(local.lists[c]);
+			local.lists[c] = local.lists[c]->next;
+		}
+		local.counts[c] -= n;
+		count -= n;
+		/* neighbouring blocks are freed as one block */
+		std::sort(blocks, blocks + n);
+		byte *start = blocks[0];
+		size_type len = nb;
+		for (size_type i = 1; i < n; i++) {
+			if (blocks[i] == start + len) {
+				len += nb;
+			} else {
+				arena.deallocate(start, len);
+				start = blocks[i];
+				len = nb;
+			}
+		}
+		arena.deallocate(start, len);
+	}
+}
+
+template <class Arena, std::size_t MaxSize, std::size_t BatchSize>
+void thread_cached_arena<Arena, MaxSize, BatchSize>::spill_all(cache & local)
+{
+	for (size_type c = 0; c < class_count; c++) {
+		spill(local, c, local.counts[c]);
+	}
+}
+
+} /* namespace StaticMemoryAllocator */
+#endif /* STATIC_MEMORY_ALLOCATOR__THREAD_CACHED_ARENA_IMPL_H__AD_ */
@@ -0,0 +1,370 @@
+/**
+ * \file StaticMemoryAllocator\tlsf_arena.cpp
+ * \author Angelos Drossos <angelos.drossos@gmail.com>
+ */
+#include "tlsf_arena.hpp"
+#include "bitops.hpp"
+
+#include <algorithm>
+#include <iostream>
+
+#include <assert.h>
+
+namespace StaticMemoryAllocator {
+
+namespace {
+
+using bitops::ctz;
+using bitops::msb;
+using bitops::all_ones;
+
+typedef tlsf_arena::size_type size_type;
+
+/* flags in the lowest bits of the block size */
+const size_type free_bit = 1;
+const size_type prev_free_bit = 2;
+const size_type flag_mask = free_bit | prev_free_bit;
+
+inline uintptr_t align_up(const uintptr_t addr, const size_type alignment)
+{
+	return (addr + alignment - 1) & ~static_cast<uintptr_t>(alignment - 1);
+}
+
+} /* anonymous namespace */
+
+const tlsf_arena::size_type tlsf_arena::granule_size;
+
+tlsf_arena::tlsf_arena(void *const memstart, const size_type memsize, const std::string & memname)
+	: start(reinterpret_cast<byte *>(align_up(reinterpret_cast<uintptr_t>(memstart), granule_size))),
+	  end(reinterpret_cast<byte *>((reinterpret_cast<uintptr_t>(memstart) + memsize) & ~static_cast<uintptr_t>(granule_size - 1))),
+	  memname(memname),
+	  fl_bitmap(0)
+{
+	assert(memstart != nullptr);
+	/* one block and the sentinel at the end */
+	assert(end > start && static_cast<size_type>(end - start) >= 2 * header_size + min_block_size);
+	std::fill(sl_bitmap, sl_bitmap + fl_count, 0);
+	std::fill(&free_lists[0][0], &free_lists[0][0] + fl_count * sl_count, nullptr);
+	block *const first = reinterpret_cast<block *>(start);
+	first->prev_phys = nullptr;
+	first->size_flags = 0;
+	set_size(first, static_cast<size_type>(end - start) - 2 * header_size);
+	/* the sentinel is a used block of size 0, thus blocks are never merged with it */
+	block *const sentinel = next_phys(first);
+	sentinel->prev_phys = first;
+	sentinel->size_flags = 0;
+	set_free(first, true);
+	set_prev_free(sentinel, true);
+	insert_free(first);
+}
+
+void *tlsf_arena::allocate(const size_type nb, const size_type alignment, void *const hint)
+{
+	assert(nb > 0);
+	assert(alignment > 0 && (alignment & (alignment - 1)) == 0);
+	(void) hint;
+	if (nb > size() || alignment > size()) return nullptr;
+	const size_type nbytes = calc_bytes(nb);
+	/* larger alignments need a gap in front of the block, which becomes a free block itself */
+	const size_type search = (alignment > granule_size) ? nbytes + alignment + header_size + min_block_size : nbytes;
+	block *b = find_block(search);
+	if (b == nullptr) return nullptr;
+	remove_free(b);
+	if (alignment > granule_size) {
+		const uintptr_t p = reinterpret_cast<uintptr_t>(payload(b));
+		uintptr_t aligned = align_up(p, alignment);
+		if (aligned != p && aligned - p < header_size + min_block_size) {
+			aligned = align_up(p + header_size + min_block_size, alignment);
+		}
+		if (aligned != p) {
+			block *const r = split(b, static_cast<size_type>(aligned - p) - header_size);
+			insert_free(b);
+			b = r;
+		}
+	}
+	set_free(b, false);
+	set_prev_free(next_phys(b), false);
+	if (block_size(b) >= nbytes + header_size + min_block_size) {
+		block *const r = split(b, nbytes);
+		set_free(r, true);
+		set_prev_free(next_phys(r), true);
+		insert_free(r);
+	}
+	return payload(b);
+}
+
+void tlsf_arena::deallocate(void *const p, const size_type nb)
+{
+	assert(p != nullptr);
+	assert(static_cast<byte *>(p) > start && static_cast<byte *>(p) < end);
+	block *b = from_payload(p);
+	assert(!is_free(b));
+	assert(nb <= block_size(b));
+	(void) nb;
+	set_free(b, true);
+	if (is_prev_free(b)) {
+		remove_free(b->prev_phys);
+		b = merge(b->prev_phys, b);
+	}
+	block *const next = next_phys(b);
+	if (is_free(next)) {
+		remove_free(next);
+		b = merge(b, next);
+	}
+	set_prev_free(next_phys(b), true);
+	insert_free(b);
+}
+
+bool tlsf_arena::expand(void *const p, const size_type old_nb, const size_type new_nb)
+{
+	assert(old_nb > 0 && new_nb > 0);
+	(void) old_nb;
+	if (new_nb > size()) return false;
+	block *const b = from_payload(p);
+	assert(!is_free(b));
+	const size_type nbytes = calc_bytes(new_nb);
+	if (nbytes <= block_size(b)) return true;
+	block *const next = next_phys(b);
+	if (!is_free(next) || block_size(b) + header_size + block_size(next) < nbytes) return false;
+	remove_free(next);
+	merge(b, next);
+	set_prev_free(next_phys(b), false);
+	if (block_size(b) >= nbytes + header_size + min_block_size) {
+		block *const r = split(b, nbytes);
+		set_free(r, true);
+		set_prev_free(next_phys(r), true);
+		insert_free(r);
+	}
+	return true;
+}
+
+bool tlsf_arena::shrink(void *const p, const size_type old_nb, const size_type new_nb)
+{
+	assert(old_nb > 0 && new_nb > 0);
+	(void) old_nb;
+	block *const b = from_payload(p);
+	assert(!is_free(b));
+	const size_type nbytes = calc_bytes(new_nb);
+	/* the rest is too small for a block of its own, thus it stays a part of the block */
+	if (block_size(b) < nbytes + header_size + min_block_size) return true;
+	block *r = split(b, nbytes);
+	set_free(r, true);
+	block *const next = next_phys(r);
+	if (is_free(next)) {
+		remove_free(next);
+		r = merge(r, next);
+	}
+	set_prev_free(next_phys(r), true);
+	insert_free(r);
+	return true;
+}
+
+tlsf_arena::size_type tlsf_arena::max_size(void) const
+{
+	if (fl_bitmap == 0) return 0;
+	/* the largest block is in the highest non-empty list (which is searched, unlike by allocate()) */
+	const size_type fl = msb(fl_bitmap);
+	const size_type sl = msb(sl_bitmap[fl]);
+	size_type largest = 0;
+	for (block *b = free_lists[fl][sl]; b != nullptr; b = links(b).next) {
+		largest = std::max(largest, block_size(b));
+	}
+	return largest;
+}
+
+tlsf_arena::size_type tlsf_arena::size(void) const
+{
+	return static_cast<size_type>(end - start);
+}
+
+void *const tlsf_arena::memstart(void) const
+{
+	return start;
+}
+
+void *const tlsf_arena::memend(void) const
+{
+	return end;
+}
+
+const std::string & tlsf_arena::name(void) const
+{
+	return memname;
+}
+
+bool tlsf_arena::operator ==(const tlsf_arena & a) const
+{
+	return this == &a;
+}
+
+void tlsf_arena::print_free_memory(void) const
+{
+	std::cout << "free memory (" << ((memname.empty()) ? "<unnamed>" : memname) << "):";
+	for (block *b = reinterpret_cast<block *>(start); block_size(b) > 0; b = next_phys(b)) {
+		if (is_free(b)) std::cout << " [" << static_cast<void *>(payload(b)) << ", +" << block_size(b) << ")";
+	}
+	std::cout << " at [" << static_cast<void *>(start) << ", " << static_cast<void *>(end) << ")" << std::endl;
+}
+
+tlsf_arena::size_type tlsf_arena::calc_bytes(const size_type nb)
+{
+	return (nb > min_block_size) ? static_cast<size_type>(align_up(nb, granule_size)) : min_block_size;
+}
+
+tlsf_arena::size_type tlsf_arena::block_size(const block *const b)
+{
+	return b->size_flags & ~flag_mask;
+}
+
+bool tlsf_arena::is_free(const block *const b)
+{
+	return (b->size_flags & free_bit) != 0;
+}
+
+bool tlsf_arena::is_prev_free(const block *const b)
+{
+	return (b->size_flags & prev_free_bit) != 0;
+}
+
+void tlsf_arena::set_size(block *const b, const size_type size)
+{
+	assert((size & flag_mask) == 0);
+	b->size_flags = size | (b->size_flags & flag_mask);
+}
+
+void tlsf_arena::set_free(block *const b, const bool free)
+{
+	b->size_flags = free ? (b->size_flags | free_bit) : (b->size_flags & ~free_bit);
+}
+
+void tlsf_arena::set_prev_free(block *const b, const bool free)
+{
+	b->size_flags = free ? (b->size_flags | prev_free_bit) : (b->size_flags & ~prev_free_bit);
+}
+
+tlsf_arena::byte *tlsf_arena::payload(block *const b)
+{
+	return reinterpret_cast<byte *>(b) + header_size;
+}
+
+tlsf_arena::block *tlsf_arena::from_payload(void *const p)
+{
+	return reinterpret_cast<block *>(static_cast<byte *>(p) - header_size);
+}
+
+tlsf_arena::block *tlsf_arena::next_phys(block *const b)
+{
+	return reinterpret_cast<block *>(payload(b) + block_size(b));
+}
+
+tlsf_arena::free_links & tlsf_arena::links(block *const b)
+{
+	return *reinterpret_cast<free_links *>(payload(b));
+}
+
+void tlsf_arena::mapping(const size_type size, size_type & fl, size_type & sl)
+{
+	if (size < small_block_size) {
+		/* small blocks are split linearly into the lists of the first level 0 */
+		fl = 0;
+		sl = size / (small_block_size / sl_count);
+	} else {
+		const size_type f = msb(size);
+		sl = (size >> (f - sl_log2)) ^ sl_count;
+		fl = f - fl_shift + 1;
+	}
+	assert(sl < sl_count);
+}
+
+tlsf_arena::block *tlsf_arena::find_block(const size_type size) const
+{
+	/* round up to the next list, thus each block of the list found is large enough */
+	const size_type rounded = (size >= small_block_size)
+		? size + (static_cast<size_type>(1) << (msb(size) - sl_log2)) - 1
+		: size;
+	size_type fl, sl;
+	mapping(rounded, fl, sl);
+	block *b = (fl < fl_count) ? find_suitable(fl, sl) : nullptr;
+	if (b != nullptr) return b;
+	/*
+	 * the list of size itself may still hold a large enough block (e.g. the only free block):
+	 * only its first block is checked, searching the list would depend on the fragmentation
+	 */
+	mapping(size, fl, sl);
+	b = free_lists[fl][sl];
+	return (b != nullptr && block_size(b) >= size) ? b : nullptr;
+}
+
+tlsf_arena::block *tlsf_arena::find_suitable(size_type & fl, size_type & sl) const
+{
+	assert(fl < fl_count && sl < sl_count);
+	uint64_t sl_map = sl_bitmap[fl] & (all_ones << sl);
+	if (sl_map == 0) {
+		/* no list of this power of two, take the smallest list of a larger one */
+		const uint64_t fl_map = (fl + 1 < 64) ? (fl_bitmap & (all_ones << (fl + 1))) : 0;
+		if (fl_map == 0) return nullptr;
+		fl = ctz(fl_map);
+		sl_map = sl_bitmap[fl];
+	}
+	sl = ctz(sl_map);
+	assert(free_lists[fl][sl] != nullptr);
+	return free_lists[fl][sl];
+}
+
+void tlsf_arena::insert_free(block *const b)
+{
+	assert(is_free(b));
+	size_type fl, sl;
+	mapping(block_size(b), fl, sl);
+	block *const head = free_lists[fl][sl];
+	links(b).next = head;
+	links(b).prev = nullptr;
+	if (head != nullptr) links(head).prev = b;
+	free_lists[fl][sl] = b;
+	fl_bitmap |= static_cast<uint64_t>(1) << fl;
+	sl_bitmap[fl] |= static_cast<uint32_t>(1) << sl;
+}
+
+void tlsf_arena::remove_free(block *const b)
+{
+	assert(is_free(b));
+	size_type fl, sl;
+	mapping(block_size(b), fl, sl);
+	block *const next = links(b).next;
+	block *const prev = links(b).prev;
+	if (next != nullptr) links(next).prev = prev;
+	if (prev != nullptr) {
+		links(prev).next = next;
+	} else {
+		assert(free_lists[fl][sl] == b);
+		free_lists[fl][sl] = next;
+		if (next == nullptr) {
+			sl_bitmap[fl] &= ~(static_cast<uint32_t>(1) << sl);
+			if (sl_bitmap[fl] == 0) fl_bitmap &= ~(static_cast<uint64_t>(1) << fl);
+		}
+	}
+}
+
+tlsf_arena::block *tlsf_arena::split(block *const b, const size_type size)
+{
+	/* the remainder behind the first size bytes of b becomes a new (used) block */
+	assert(block_size(b) >= size + header_size + min_block_size);
+	block *const r = reinterpret_cast<block *>(payload(b) + size);
+	r->prev_phys = b;
+	r->size_flags = 0;
+	set_size(r, block_size(b) - size - header_size);
+	set_prev_free(r, is_free(b));
+	next_phys(r)->prev_phys = r;
+	set_size(b, size);
+	return r;
+}
+
+tlsf_arena::block *tlsf_arena::merge(block *const prev, block *const b)
+{
+	assert(next_phys(prev) == b);
+	set_size(prev, block_size(prev) + header_size + block_size(b));
+	next_phys(prev)->prev_phys = prev;
+	return prev;
+}
+
+} /* namespace StaticMemoryAllocator */
@@ -0,0 +1,205 @@
+#ifndef STATIC_MEMORY_ALLOCATOR__TLSF_ARENA_H__AD_
+#define STATIC_MEMORY_ALLOCATOR__TLSF_ARENA_H__AD_
+
+/**
+ * \file StaticMemoryAllocator\tlsf_arena.hpp
+ * \author Angelos Drossos <angelos.drossos@gmail.com>
+ */
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+
+namespace StaticMemoryAllocator {
+
+/**
+ * Manages a static memory block [memstart, memend()) by a
+ * two-level segregated fit (TLSF) allocator.
+ *
+ * Free blocks are kept in lists by size: the first level splits the
+ * sizes into powers of two, the second level splits each power of two
+ * linearly into 16 lists. Two levels of bitmaps tell which lists are
+ * not empty, thus a large enough free block is found by two bit scans.
+ * Each block has a header in front of it (linking its physical
+ * neighbour), thus freed blocks are merged with their free neighbours
+ * immediately. Allocating, freeing and merging are O(1) and do not
+ * depend on the fragmentation of the memory block: an allocation
+ * takes a block of a list of larger sizes, or else checks only the first
+ * block of the list of its own size. Thus an allocation may fail, although
+ * another block of that list would be large enough (see max_size()).
+ *
+ * The block headers are stored inside the managed memory block
+ * (16 bytes per block, and each block is a multiple of 16 bytes).
+ * The arena must not be used by several threads at the same time.
+ */
+class tlsf_arena
+{
+public:
+	typedef std::size_t        size_type;
+
+	static const size_type granule_size = 16;
+
+/* constructors, destructors, assignment operators */
+public:
+
+	tlsf_arena() = delete;
+
+	tlsf_arena(void *const memstart, const size_type memsize, const std::string & memname = "");
+
+	tlsf_arena(const tlsf_arena & a) = delete;
+
+	tlsf_arena & operator =(const tlsf_arena & a) = delete;
+
+/* arena functions */
+public:
+
+	/**
+	 * Reserves a memory block of (at least) \p nb bytes.
+	 *
+	 * \param nb Size of the memory block in bytes.
+	 * \param alignment Alignment of the memory block (a power of two).
+	 * \param hint Not used.
+	 * \return Pointer to the memory block, or nullptr if there is no
+	 *         large enough free memory block.
+	 *
+	 * Only if no list of larger blocks is left, the first block of the
+	 * list of the requested size is taken, if it is large enough
+	 * (e.g. the last free block). The list is not searched, thus the
+	 * time does not depend on the number of free blocks.
+	 */
+	void *allocate(const size_type nb, const size_type alignment, void *const hint = nullptr);
+
+	/**
+	 * Frees the memory block at \p p (which was reserved by allocate()).
+	 */
+	void deallocate(void *const p, const size_type nb);
+
+	/**
+	 * Grows the memory block at \p p to \p new_nb bytes,
+	 * if the block behind it is free and large enough.
+	 *
+	 * \return false (and nothing changed), if the block cannot grow in place.
+	 */
+	bool expand(void *const p, const size_type old_nb, const size_type new_nb);
+
+	/**
+	 * Shrinks the memory block at \p p to \p new_nb bytes
+	 * (the rest becomes a free block, if it is large enough for one).
+	 */
+	bool shrink(void *const p, const size_type old_nb, const size_type new_nb);
+
+	/**
+	 * Returns the size of the largest free memory block in bytes.
+	 *
+	 * This searches the list of the largest blocks, thus it takes
+	 * linear time in the length of that list (unlike allocate(),
+	 * which may fail for a request of this size, if the block
+	 * is not the first one of its list).
+	 */
+	size_type max_size(void) const;
+
+	size_type size(void) const;
+
+	void *const memstart(void) const;
+
+	void *const memend(void) const;
+
+	const std::string & name(void) const;
+
+	bool operator ==(const tlsf_arena & a) const;
+
+	void print_free_memory(void) const;
+
+private:
+
+	typedef uint8_t byte;
+
+	static const size_type sl_log2 = 4;
+	static const size_type sl_count = 1 << sl_log2;
+	static const size_type fl_shift = sl_log2 + 4;
+	static const size_type fl_count = 64 - fl_shift + 1;
+	static const size_type small_block_size = 1 << fl_shift;
+
+	/* header in front of each block */
+	struct block
+	{
+		/* physical predecessor */
+		block *prev_phys;
+		/* size of the payload (behind the header), the lowest bits are flags */
+		size_type size_flags;
+	};
+
+	/* links of the free list, stored in the payload of a free block */
+	struct free_links
+	{
+		block *next;
+		block *prev;
+	};
+
+	static const size_type header_size = 16;
+	static const size_type min_block_size = 16;
+
+	static_assert(sizeof(block) <= header_size, "the block header is too large");
+	static_assert(sizeof(free_links) <= min_block_size, "the free list links do not fit into a block");
+
+	static
+	size_type calc_bytes(const size_type nb);
+
+	static
+	size_type block_size(const block *const b);
+
+	static
+	bool is_free(const block *const b);
+
+	static
+	bool is_prev_free(const block *const b);
+
+	static
+	void set_size(block *const b, const size_type size);
+
+	static
+	void set_free(block *const b, const bool free);
+
+	static
+	void set_prev_free(block *const b, const bool free);
+
+	static
+	byte *payload(block *const b);
+
+	static
+	block *from_payload(void *const p);
+
+	static
+	block *next_phys(block *const b);
+
+	static
+	free_links & links(block *const b);
+
+	static
+	void mapping(const size_type size, size_type & fl, size_type & sl);
+
+	block *find_block(const size_type size) const;
+
+	block *find_suitable(size_type & fl, size_type & sl) const;
+
+	void insert_free(block *const b);
+
+	void remove_free(block *const b);
+
+	block *split(block *const b, const size_type size);
+
+	block *merge(block *const prev, block *const b);
+
+/* member variables */
+private:
+
+	byte *start;
+	byte *end;
+	std::string memname;
+	uint64_t fl_bitmap;
+	uint32_t sl_bitmap[fl_count];
+	block *free_lists[fl_count][sl_count];
+};
+
+} /* namespace StaticMemoryAllocator */
+#endif /* STATIC_MEMORY_ALLOCATOR__TLSF_ARENA_H__AD_ */
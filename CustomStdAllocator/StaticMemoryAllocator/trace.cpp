@@ -0,0 +1,119 @@
+/**
+ * \file StaticMemoryAllocator\trace.cpp
+ * \author Angelos Drossos <angelos.drossos@gmail.com>
+ */
+#include "trace.hpp"
+
+#include <chrono>
+#include <cstdio>
+
+#include <assert.h>
+
+namespace StaticMemoryAllocator {
+
+namespace {
+
+inline std::size_t round_up_pow2(const std::size_t n)
+{
+	std::size_t p = 1;
+	while (p < n) p <<= 1;
+	return p;
+}
+
+} /* namespace */
+
+const char *trace_op_name(const trace_op op)
+{
+	switch (op) {
+	case trace_op::allocate:        return "allocate";
+	case trace_op::deallocate:      return "deallocate";
+	case trace_op::expand:          return "expand";
+	case trace_op::shrink:          return "shrink";
+	case trace_op::allocate_failed: return "allocate_failed";
+	}
+	return "unknown";
+}
+
+trace_ring::trace_ring(const size_type capacity)
+	: mask(round_up_pow2(capacity) - 1),
+	  slots(new slot[round_up_pow2(capacity)]),
+	  head(0)
+{
+	assert(capacity > 0);
+	clear();
+}
+
+void trace_ring::push(const trace_op op, const void *const arena, const uint64_t offset, const uint64_t size)
+{
+	const uint64_t timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now().time_since_epoch()).count();
+	const uint64_t i = head.fetch_add(1, std::memory_order_relaxed);
+	slot & s = slots[i & mask];
+	/* odd: the slot is written (the event i is complete, when seq is 2*i+2) */
+	s.seq.store(2 * i + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+	s.timestamp.store(timestamp, std::memory_order_relaxed);
+	s.arena.store(reinterpret_cast<uintptr_t>(arena), std::memory_order_relaxed);
+	s.offset.store(offset, std::memory_order_relaxed);
+	s.size.store(size, std::memory_order_relaxed);
+	s.op.store(static_cast<uint32_t>(op), std::memory_order_relaxed);
+	s.seq.store(2 * i + 2, std::memory_order_release);
+}
+
+std::vector<trace_event> trace_ring::events(void) const
+{
+	const uint64_t last = head.load(std::memory_order_acquire);
+	const uint64_t first = (last > mask + 1) ? last - (mask + 1) : 0;
+	std::vector<trace_event> result;
+	result.reserve(last - first);
+	for (uint64_t i = first; i < last; i++) {
+		const slot & s = slots[i & mask];
+		const uint64_t seq = s.seq.load(std::memory_order_acquire);
+		/* the event is still written or already overwritten */
+		if (seq != 2 * i + 2) continue;
+		trace_event e;
+		e.sequence = i;
+		e.timestamp = s.timestamp.load(std::memory_order_relaxed);
+		e.arena = s.arena.load(std::memory_order_relaxed);
+		e.offset = s.offset.load(std::memory_order_relaxed);
+		e.size = s.size.load(std::memory_order_relaxed);
+		e.op = s.op.load(std::memory_order_relaxed);
+		e.reserved = 0;
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if (s.seq.load(std::memory_order_relaxed) != seq) continue;
+		result.push_back(e);
+	}
+	return result;
+}
+
+bool trace_ring::dump(const std::string & path) const
+{
+	const std::vector<trace_event> e = events();
+	std::FILE *const f = std::fopen(path.c_str(), "wb");
+	if (f == nullptr) return false;
+	const uint64_t header[2] = { file_magic, e.size() };
+	bool ok = std::fwrite(header, sizeof(header), 1, f) == 1;
+	if (ok && !e.empty()) ok = std::fwrite(e.data(), sizeof(trace_event), e.size(), f) == e.size();
+	return (std::fclose(f) == 0) && ok;
+}
+
+void trace_ring::clear(void)
+{
+	for (size_type i = 0; i <= mask; i++) {
+		/* never matches an event number */
+		slots[i].seq.store(1, std::memory_order_relaxed);
+	}
+	head.store(0, std::memory_order_release);
+}
+
+uint64_t trace_ring::recorded(void) const
+{
+	return head.load(std::memory_order_relaxed);
+}
+
+trace_ring::size_type trace_ring::capacity(void) const
+{
+	return mask + 1;
+}
+
+} /* namespace StaticMemoryAllocator */
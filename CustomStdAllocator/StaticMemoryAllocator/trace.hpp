@@ -0,0 +1,174 @@
+#ifndef STATIC_MEMORY_ALLOCATOR__TRACE_H__AD_
+#define STATIC_MEMORY_ALLOCATOR__TRACE_H__AD_
+
+/**
+ * \file StaticMemoryAllocator\trace.hpp
+ * \author Angelos Drossos <angelos.drossos@gmail.com>
+ */
+
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace StaticMemoryAllocator {
+
+/**
+ * Operation of a trace event.
+ */
+enum class trace_op : uint32_t
+{
+	allocate = 1,
+	deallocate = 2,
+	expand = 3,
+	shrink = 4,
+	/* an allocation failed (the offset is 0) */
+	allocate_failed = 5
+};
+
+/**
+ * Returns the name of \p op (e.g. for the dump tool).
+ */
+const char *trace_op_name(const trace_op op);
+
+/**
+ * Binary record of an event, as written by trace_ring::dump().
+ */
+struct trace_event
+{
+	/* number of the event (counting all events of the ring) */
+	uint64_t sequence;
+	/* time of the event in nanoseconds (of the steady clock) */
+	uint64_t timestamp;
+	/* address of the arena */
+	uint64_t arena;
+	/* offset of the memory block in the memory block of the arena */
+	uint64_t offset;
+	/* size of the memory block in bytes (the new size for expand and shrink) */
+	uint64_t size;
+	uint32_t op;
+	uint32_t reserved;
+};
+
+/**
+ * Ring buffer of trace events, which can be written by several threads
+ * at the same time without a lock: a writer claims the next slot by an
+ * atomic increment and overwrites the oldest event, if the ring is full.
+ *
+ * Each slot has a sequence number (odd while it is written), thus a reader
+ * skips the slots, which are written at the same time, instead of
+ * reading torn events.
+ */
+class trace_ring
+{
+public:
+	typedef std::size_t        size_type;
+
+	/* "SMATRACE" (little endian), the first 8 bytes of a dump file */
+	static const uint64_t file_magic = 0x4543415254414d53ull;
+
+/* constructors, destructors, assignment operators */
+public:
+
+	trace_ring() = delete;
+
+	/**
+	 * Constructs a ring of \p capacity events (rounded up to a power of two).
+	 */
+	explicit trace_ring(const size_type capacity);
+
+	trace_ring(const trace_ring & r) = delete;
+
+	trace_ring & operator =(const trace_ring & r) = delete;
+
+/* ring functions */
+public:
+
+	void push(const trace_op op, const void *const arena, const uint64_t offset, const uint64_t size);
+
+	/**
+	 * Returns the events in the ring (at most capacity() of the last ones)
+	 * in the order they were recorded.
+	 */
+	std::vector<trace_event> events(void) const;
+
+	/**
+	 * Writes the events to the file \p path: the file_magic,
+	 * the number of events (both as uint64_t) and the trace_event records.
+	 *
+	 * \return false, if the file could not be written.
+	 */
+	bool dump(const std::string & path) const;
+
+	/**
+	 * Removes all events (no other thread may push at the same time).
+	 */
+	void clear(void);
+
+	/**
+	 * Returns the number of events pushed so far (including the overwritten ones).
+	 */
+	uint64_t recorded(void) const;
+
+	size_type capacity(void) const;
+
+private:
+
+	struct slot
+	{
+		std::atomic<uint64_t> seq;
+		std::atomic<uint64_t> timestamp;
+		std::atomic<uint64_t> arena;
+		std::atomic<uint64_t> offset;
+		std::atomic<uint64_t> size;
+		std::atomic<uint32_t> op;
+	};
+
+/* member variables */
+private:
+
+	size_type mask;
+	std::unique_ptr<slot[]> slots;
+	std::atomic<uint64_t> head;
+};
+
+/**
+ * Tracing policy, which does not trace anything (the default):
+ * allocator<T, Arena, null_trace> does not compute any event.
+ */
+struct null_trace
+{
+	static const bool enabled = false;
+
+	static
+	void record(const trace_op, const void *const, const uint64_t, const uint64_t) {}
+};
+
+/**
+ * Tracing policy, which records the events of all its allocators
+ * into one trace_ring of \p Capacity events, e.g. to be written by
+ * ring_trace<>::ring().dump(path) and read by the trace_dump tool.
+ */
+template <std::size_t Capacity = 65536>
+struct ring_trace
+{
+	static const bool enabled = true;
+
+	static
+	trace_ring & ring(void)
+	{
+		static trace_ring r(Capacity);
+		return r;
+	}
+
+	static
+	void record(const trace_op op, const void *const arena, const uint64_t offset, const uint64_t size)
+	{
+		ring().push(op, arena, offset, size);
+	}
+};
+
+} /* namespace StaticMemoryAllocator */
+#endif /* STATIC_MEMORY_ALLOCATOR__TRACE_H__AD_ */
@@ -0,0 +1,162 @@
+#ifndef STATIC_MEMORY_ALLOCATOR__VECTOR_H__AD_
+#define STATIC_MEMORY_ALLOCATOR__VECTOR_H__AD_
+
+/**
+ * \file StaticMemoryAllocator\vector.hpp
+ * \author Angelos Drossos <angelos.drossos@gmail.com>
+ */
+
+#include "allocator.hpp"
+
+#include <cstddef>
+
+namespace StaticMemoryAllocator {
+
+/**
+ * Vector of a static memory block, which grows in place.
+ *
+ * Unlike std::vector, the vector tries to grow (and shrink) its memory
+ * block in place by the allocator (expand_in_place(), shrink_in_place())
+ * first. Only if the memory behind the block is not free, a new block
+ * is allocated and the elements are moved to it. Thus the vector can
+ * use (nearly) the whole free memory behind its block, and growing does
+ * not copy the elements, as long as nothing else is allocated behind it.
+ *
+ * \tparam T Value type.
+ * \tparam Allocator Type of the allocator, which has to provide
+ * 	      expand_in_place() and shrink_in_place().
+ */
+template <class T, class Allocator = allocator<T>>
+class vector
+{
+public:
+	typedef T                                   value_type;
+	typedef Allocator                           allocator_type;
+	typedef typename Allocator::size_type       size_type;
+	typedef typename Allocator::difference_type difference_type;
+	typedef value_type                        & reference;
+	typedef const value_type                  & const_reference;
+	typedef typename Allocator::pointer         pointer;
+	typedef typename Allocator::const_pointer   const_pointer;
+	typedef pointer                             iterator;
+	typedef const_pointer                       const_iterator;
+
+/* constructors, destructors, assignment operators */
+public:
+
+	vector() = delete;
+
+	explicit vector(const allocator_type & alloc);
+
+	vector(const vector & v);
+
+	vector(vector && v);
+
+	~vector();
+
+	vector & operator =(const vector & v);
+
+	/**
+	 * Takes the memory block of \p v, if the allocator propagates on move
+	 * assignment or both allocators are equal, otherwise moves the elements.
+	 */
+	vector & operator =(vector && v);
+
+/* element access */
+public:
+
+	reference operator [](const size_type i);
+
+	const_reference operator [](const size_type i) const;
+
+	reference front(void);
+
+	const_reference front(void) const;
+
+	reference back(void);
+
+	const_reference back(void) const;
+
+	pointer data(void);
+
+	const_pointer data(void) const;
+
+	iterator begin(void);
+
+	const_iterator begin(void) const;
+
+	iterator end(void);
+
+	const_iterator end(void) const;
+
+/* capacity */
+public:
+
+	bool empty(void) const;
+
+	size_type size(void) const;
+
+	size_type capacity(void) const;
+
+	/**
+	 * Changes the capacity to (at least) \p n elements:
+	 * in place, if possible, otherwise the elements are moved to a new block.
+	 *
+	 * \throw std::bad_alloc If there is no large enough free memory block.
+	 */
+	void reserve(const size_type n);
+
+	/**
+	 * Shrinks the memory block in place to the size of the vector
+	 * (the capacity is unchanged, if the allocator cannot shrink the block).
+	 */
+	void shrink_to_fit(void);
+
+/* modifiers */
+public:
+
+	void clear(void);
+
+	void push_back(const value_type & value);
+
+	void push_back(value_type && value);
+
+	template <class... Args>
+	void emplace_back(Args&&... args);
+
+	void pop_back(void);
+
+	void resize(const size_type n);
+
+	void resize(const size_type n, const value_type & value);
+
+	/**
+	 * Swaps the memory blocks (and the allocators, if they propagate on swap).
+	 */
+	void swap(vector & v);
+
+	allocator_type get_allocator(void) const;
+
+private:
+
+	/* makes room for one more element */
+	void grow(void);
+
+	/* moves the elements into a new memory block of n elements */
+	void reallocate(const size_type n);
+
+	void destroy_all(void);
+
+	void release(void);
+
+/* member variables */
+private:
+
+	allocator_type alloc;
+	pointer first;
+	size_type count;
+	size_type cap;
+};
+
+} /* namespace StaticMemoryAllocator */
+#endif /* STATIC_MEMORY_ALLOCATOR__VECTOR_H__AD_ */
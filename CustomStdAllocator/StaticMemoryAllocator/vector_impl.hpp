@@ -0,0 +1,336 @@
+#ifndef STATIC_MEMORY_ALLOCATOR__VECTOR_IMPL_H__AD_
+#define STATIC_MEMORY_ALLOCATOR__VECTOR_IMPL_H__AD_
+
+#include "vector.hpp"
+
+#include <algorithm>
+#include <memory>
+#include <new>
+#include <utility>
+
+#include <assert.h>
+
+namespace StaticMemoryAllocator {
+
+template <class T, class Allocator>
+vector<T, Allocator>::vector(const allocator_type & alloc)
+	: alloc(alloc),
+	  first(nullptr),
+	  count(0),
+	  cap(0)
+{
+}
+
+template <class T, class Allocator>
+vector<T, Allocator>::vector(const vector & v)
+	: alloc(v.alloc),
+	  first(nullptr),
+	  count(0),
+	  cap(0)
+{
+	reserve(v.count);
+	for (const_iterator it = v.begin(); it != v.end(); ++it) push_back(*it);
+}
+
+template <class T, class Allocator>
+vector<T, Allocator>::vector(vector && v)
+	: alloc(v.alloc),
+	  first(v.first),
+	  count(v.count),
+	  cap(v.cap)
+{
+	v.first = nullptr;
+	v.count = 0;
+	v.cap = 0;
+}
+
+template <class T, class Allocator>
+vector<T, Allocator>::~vector()
+{
+	release();
+}
+
+template <class T, class Allocator>
+vector<T, Allocator> & vector<T, Allocator>::operator =(const vector & v)
+{
+	if (this == &v) return *this;
+	clear();
+	reserve(v.count);
+	for (const_iterator it = v.begin(); it != v.end(); ++it) push_back(*it);
+	return *this;
+}
+
+template <class T, class Allocator>
+vector<T, Allocator> & vector<T, Allocator>::operator =(vector && v)
+{
+	if (this == &v) return *this;
+	if (!std::allocator_traits<Allocator>::propagate_on_container_move_assignment::value && alloc != v.alloc) {
+		/* the block of v belongs to another memory block, thus the elements are moved one by one */
+		clear();
+		reserve(v.count);
+		for (iterator it = v.begin(); it != v.end(); ++it) push_back(std::move(*it));
+		v.release();
+		return *this;
+	}
+	release();
+	if (std::allocator_traits<Allocator>::propagate_on_container_move_assignment::value) alloc = v.alloc;
+	first = v.first;
+	count = v.count;
+	cap = v.cap;
+	v.first = nullptr;
+	v.count = 0;
+	v.cap = 0;
+	return *this;
+}
+
+template <class T, class Allocator>
+typename vector<T, Allocator>::reference vector<T, Allocator>::operator [](const size_type i)
+{
+	assert(i < count);
+	return first[i];
+}
+
+template <class T, class Allocator>
+typename vector<T, Allocator>::const_reference vector<T, Allocator>::operator [](const size_type i) const
+{
+	assert(i < count);
+	return first[i];
+}
+
+template <class T, class Allocator>
+typename vector<T, Allocator>::reference vector<T, Allocator>::front(void)
+{
+	assert(count > 0);
+	return first[0];
+}
+
+template <class T, class Allocator>
+typename vector<T, Allocator>::const_reference vector<T, Allocator>::front(void) const
+{
+	assert(count > 0);
+	return first[0];
+}
+
+template <class T, class Allocator>
+typename vector<T, Allocator>::reference vector<T, Allocator>::back(void)
+{
+	assert(count > 0);
+	return first[count - 1];
+}
+
+template <class T, class Allocator>
+typename vector<T, Allocator>::const_reference vector<T, Allocator>::back(void) const
+{
+	assert(count > 0);
+	return first[count - 1];
+}
+
+template <class T, class Allocator>
+typename vector<T, Allocator>::pointer vector<T, Allocator>::data(void)
+{
+	return first;
+}
+
+template <class T, class Allocator>
+typename vector<T, Allocator>::const_pointer vector<T, Allocator>::data(void) const
+{
+	return first;
+}
+
+template <class T, class Allocator>
+typename vector<T, Allocator>::iterator vector<T, Allocator>::begin(void)
+{
+	return first;
+}
+
+template <class T, class Allocator>
+typename vector<T, Allocator>::const_iterator vector<T, Allocator>::begin(void) const
+{
+	return first;
+}
+
+template <class T, class Allocator>
+typename vector<T, Allocator>::iterator vector<T, Allocator>::end(void)
+{
+	return first + count;
+}
+
+template <class T, class Allocator>
+typename vector<T, Allocator>::const_iterator vector<T, Allocator>::end(void) const
+{
+	return first + count;
+}
+
+template <class T, class Allocator>
+bool vector<T, Allocator>::empty(void) const
+{
+	return count == 0;
+}
+
+template <class T, class Allocator>
+typename vector<T, Allocator>::size_type vector<T, Allocator>::size(void) const
+{
+	return count;
+}
+
+template <class T, class Allocator>
+typename vector<T, Allocator>::size_type vector<T, Allocator>::capacity(void) const
+{
+	return cap;
+}
+
+template <class T, class Allocator>
+void vector<T, Allocator>::reserve(const size_type n)
+{
+	if (n <= cap) return;
+	if (cap > 0 && alloc.expand_in_place(first, cap, n)) {
+		cap = n;
+		return;
+	}
+	reallocate(n);
+}
+
+template <class T, class Allocator>
+void vector<T, Allocator>::shrink_to_fit(void)
+{
+	if (count == cap) return;
+	if (count == 0) {
+		release();
+		return;
+	}
+	if (alloc.shrink_in_place(first, cap, count)) cap = count;
+}
+
+template <class T, class Allocator>
+void vector<T, Allocator>::clear(void)
+{
+	destroy_all();
+}
+
+template <class T, class Allocator>
+void vector<T, Allocator>::push_back(const value_type & value)
+{
+	emplace_back(value);
+}
+
+template <class T, class Allocator>
+void vector<T, Allocator>::push_back(value_type && value)
+{
+	emplace_back(std::move(value));
+}
+
+template <class T, class Allocator>
+template <class... Args>
+void vector<T, Allocator>::emplace_back(Args&&... args)
+{
+	if (count == cap) {
+		/* the arguments may refer to an element, which is moved by grow() */
+		value_type value(std::forward<Args>(args)...);
+		grow();
+		alloc.construct(first + count, std::move(value));
+	} else {
+		alloc.construct(first + count, std::forward<Args>(args)...);
+	}
+	count++;
+}
+
+template <class T, class Allocator>
+void vector<T, Allocator>::pop_back(void)
+{
+	assert(count > 0);
+	count--;
+	alloc.destroy(first + count);
+}
+
+template <class T, class Allocator>
+void vector<T, Allocator>::resize(const size_type n)
+{
+	while (count > n) pop_back();
+	reserve(n);
+	while (count < n) emplace_back();
+}
+
+template <class T, class Allocator>
+void vector<T, Allocator>::resize(const size_type n, const value_type & value)
+{
+	while (count > n) pop_back();
+	reserve(n);
+	while (count < n) emplace_back(value);
+}
+
+template <class T, class Allocator>
+void vector<T, Allocator>::swap(vector & v)
+{
+	assert(std::allocator_traits<Allocator>::propagate_on_container_swap::value || !(alloc != v.alloc));
+	if (std::allocator_traits<Allocator>::propagate_on_container_swap::value) std::swap(alloc, v.alloc);
+	std::swap(first, v.first);
+	std::swap(count, v.count);
+	std::swap(cap, v.cap);
+}
+
+template <class T, class Allocator>
+typename vector<T, Allocator>::allocator_type vector<T, Allocator>::get_allocator(void) const
+{
+	return alloc;
+}
+
+template <class T, class Allocator>
+void vector<T, Allocator>::grow(void)
+{
+	const size_type n = cap + 1;
+	if (cap == 0) {
+		reallocate(1);
+		return;
+	}
+	/* double the capacity, in place if possible, otherwise by the needed element only */
+	if (alloc.expand_in_place(first, cap, 2 * cap)) {
+		cap = 2 * cap;
+		return;
+	}
+	if (alloc.expand_in_place(first, cap, n)) {
+		cap = n;
+		return;
+	}
+	try {
+		reallocate(2 * cap);
+	} catch (const std::bad_alloc &) {
+		reallocate(n);
+	}
+}
+
+template <class T, class Allocator>
+void vector<T, Allocator>::reallocate(const size_type n)
+{
+	assert(n >= count);
+	const pointer p = alloc.allocate(n);
+	size_type moved = 0;
+	try {
+		for (; moved < count; moved++) alloc.construct(p + moved, std::move_if_noexcept(first[moved]));
+	} catch (...) {
+		while (moved > 0) alloc.destroy(p + --moved);
+		alloc.deallocate(p, n);
+		throw;
+	}
+	release();
+	first = p;
+	count = moved;
+	cap = n;
+}
+
+template <class T, class Allocator>
+void vector<T, Allocator>::destroy_all(void)
+{
+	while (count > 0) alloc.destroy(first + --count);
+}
+
+template <class T, class Allocator>
+void vector<T, Allocator>::release(void)
+{
+	destroy_all();
+	if (cap > 0) alloc.deallocate(first, cap);
+	first = nullptr;
+	cap = 0;
+}
+
+} /* namespace StaticMemoryAllocator */
+#endif /* STATIC_MEMORY_ALLOCATOR__VECTOR_IMPL_H__AD_ */
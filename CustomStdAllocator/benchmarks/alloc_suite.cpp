@@ -0,0 +1,500 @@
+#include "StaticMemoryAllocator/allocator.hpp"
+
+#include <memory>
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <map>
+#include <string>
+#include <limits>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <thread>
+#include <chrono>
+
+#include <sys/resource.h>
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+/**
+ * Benchmark suite of reproducible workloads, comparing the
+ * StaticMemoryAllocator::allocator with malloc and std::allocator:
+ *
+ * - vector_growth: push_back into std::vectors, which grow from empty
+ * - map_churn: erase a random key of a std::map and insert a new one
+ * - random_trace: replay a trace of random-size allocations and deallocations
+ *   (sizes from 8 to 4096 bytes), for arena sizes from 1 KB to 1 GB
+ * - producer_consumer: one thread allocates, another thread deallocates
+ *   (the StaticMemoryAllocator uses a concurrent_arena)
+ *
+ * The random numbers have fixed seeds, thus each run replays the same workloads.
+ * The output is tab-separated with one header line, thus it can be kept and
+ * compared to find regressions. Columns:
+ *
+ * - workload, allocator
+ * - arena_bytes: size of the arena (malloc and std::allocator run the same workload)
+ * - ops: number of timed operations
+ * - ns_per_op: mean time of an operation
+ * - p50_ns, p99_ns: percentiles of the time of every 8th operation
+ *   (the time of reading the clock is subtracted)
+ * - failed: number of allocations, which failed
+ * - peak_rss_kb: peak resident memory of the process while the workload ran
+ *   (the workloads write the first byte of each block, thus its page is used)
+ * - fragmentation: bitmap_arena::stats().fragmentation at the end of the
+ *   workload (nan for malloc and std::allocator)
+ *
+ * usage: alloc_suite [operations] [largest arena size in bytes]
+ */
+
+static const size_t granule = 16;
+
+typedef StaticMemoryAllocator::bitmap_arena<granule>      bitmap_arena;
+typedef StaticMemoryAllocator::concurrent_arena<granule>  concurrent_arena;
+
+#include "StaticMemoryAllocator/allocator_impl.hpp"
+template class StaticMemoryAllocator::allocator<char, bitmap_arena>;
+template class StaticMemoryAllocator::allocator<char, concurrent_arena>;
+
+typedef std::chrono::steady_clock clock_type;
+
+/* every sample_stride-th operation is timed on its own */
+static const size_t sample_stride = 8;
+/* arena size of the workloads, which do not sweep it */
+static const size_t workload_arena_size = 64 << 20;
+static const size_t min_block_size = 8;
+static const size_t max_block_size = 4096;
+
+/* time of reading the clock twice in nanoseconds (see calibrate_clock()) */
+static double clock_overhead = 0;
+
+struct result
+{
+	size_t ops;
+	double ns_per_op;
+	double p50_ns;
+	double p99_ns;
+	size_t failed;
+	double fragmentation;
+};
+
+static uint64_t next_random(uint64_t & x)
+{
+	x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+	return x;
+}
+
+static double elapsed_ns(const clock_type::time_point start)
+{
+	return std::chrono::duration<double, std::nano>(clock_type::now() - start).count();
+}
+
+static void calibrate_clock(void)
+{
+	std::vector<double> samples(1001);
+	for (auto & s : samples) s = elapsed_ns(clock_type::now());
+	std::nth_element(samples.begin(), samples.begin() + samples.size() / 2, samples.end());
+	clock_overhead = samples[samples.size() / 2];
+}
+
+static void add_sample(std::vector<double> & samples, const clock_type::time_point start)
+{
+	samples.push_back(std::max(0.0, elapsed_ns(start) - clock_overhead));
+}
+
+static double percentile(std::vector<double> & samples, const double q)
+{
+	if (samples.empty()) return 0;
+	const size_t i = std::min(samples.size() - 1, static_cast<size_t>(q * samples.size()));
+	std::nth_element(samples.begin(), samples.begin() + i, samples.end());
+	return samples[i];
+}
+
+/*
+ * Runs op(i) for i in [0, ops), timing every sample_stride-th call on its own.
+ * Returns the time of all calls in nanoseconds.
+ */
+template <class Op>
+double timed_loop(const size_t ops, std::vector<double> & samples, Op op)
+{
+	samples.reserve(samples.size() + ops / sample_stride + 1);
+	const clock_type::time_point start = clock_type::now();
+	for (size_t i = 0; i < ops; i++) {
+		if (i % sample_stride != 0) {
+			op(i);
+			continue;
+		}
+		const clock_type::time_point t = clock_type::now();
+		op(i);
+		add_sample(samples, t);
+	}
+	return elapsed_ns(start);
+}
+
+static result make_result(const size_t ops, const double ns, std::vector<double> & samples)
+{
+	result r;
+	r.ops = ops;
+	r.ns_per_op = (ops > 0) ? ns / ops : 0;
+	r.p50_ns = percentile(samples, 0.50);
+	r.p99_ns = percentile(samples, 0.99);
+	r.failed = 0;
+	r.fragmentation = std::numeric_limits<double>::quiet_NaN();
+	return r;
+}
+
+/* returns a size in [min_block_size, limit], where each power of two is as likely */
+static size_t random_size(uint64_t & x, const size_t limit)
+{
+	size_t levels = 0;
+	while ((min_block_size << (levels + 1)) <= limit) levels++;
+	const size_t base = min_block_size << (next_random(x) % (levels + 1));
+	return std::min(limit, base + next_random(x) % base);
+}
+
+/*
+ * peak resident memory: Linux resets the peak (VmHWM) to the current
+ * resident memory, if "5" is written to /proc/self/clear_refs;
+ * otherwise the peak of the whole process (getrusage) is reported.
+ */
+
+static void reset_peak_rss(void)
+{
+#ifdef __GLIBC__
+	/* give back the free memory of the workloads before */
+	malloc_trim(0);
+#endif
+	std::ofstream clear_refs("/proc/self/clear_refs");
+	clear_refs << "5" << std::endl;
+}
+
+static size_t peak_rss_kb(void)
+{
+	std::ifstream status("/proc/self/status");
+	std::string line;
+	while (std::getline(status, line)) {
+		if (line.compare(0, 6, "VmHWM:") == 0) return std::strtoul(line.c_str() + 6, nullptr, 10);
+	}
+	struct rusage usage;
+	getrusage(RUSAGE_SELF, &usage);
+	return usage.ru_maxrss;
+}
+
+/*
+ * the allocators under test: each heap hands out an allocator
+ * for a workload of arena_bytes
+ */
+
+template <class T>
+struct malloc_allocator
+{
+	typedef T value_type;
+
+	malloc_allocator() {}
+
+	template <class T2>
+	malloc_allocator(const malloc_allocator<T2> &) {}
+
+	T *allocate(const size_t n)
+	{
+		void *const p = std::malloc(n * sizeof(T));
+		if (p == nullptr) throw std::bad_alloc();
+		return static_cast<T *>(p);
+	}
+
+	void deallocate(T *const p, const size_t) { std::free(p); }
+
+	template <class T2>
+	bool operator ==(const malloc_allocator<T2> &) const { return true; }
+
+	template <class T2>
+	bool operator !=(const malloc_allocator<T2> &) const { return false; }
+};
+
+template <class Allocator>
+class system_heap
+{
+public:
+	typedef Allocator allocator_type;
+
+	system_heap(const char *const, const size_t) {}
+
+	allocator_type get_allocator(void) const { return allocator_type(); }
+
+	double fragmentation(void) const { return std::numeric_limits<double>::quiet_NaN(); }
+};
+
+template <class Arena>
+class arena_heap
+{
+public:
+	typedef StaticMemoryAllocator::allocator<char, Arena> allocator_type;
+
+	/* the memory is not touched, thus only the used pages count to the resident memory */
+	arena_heap(const char *const name, const size_t memsize)
+		: mem(new uint8_t[memsize]),
+		  arena(mem.get(), memsize, name)
+	{}
+
+	allocator_type get_allocator(void) { return allocator_type(arena); }
+
+	double fragmentation(void) const { return arena.stats().fragmentation; }
+
+private:
+	std::unique_ptr<uint8_t[]> mem;
+	Arena arena;
+};
+
+/*
+ * the workloads
+ */
+
+struct vector_growth
+{
+	size_t ops;
+
+	template <class Heap>
+	result operator ()(Heap & heap) const
+	{
+		typedef typename std::allocator_traits<typename Heap::allocator_type>::template rebind_alloc<uint64_t> allocator_type;
+		const size_t length = std::max<size_t>(1, std::min<size_t>(ops, 1 << 16));
+		const allocator_type alloc(heap.get_allocator());
+		std::vector<std::vector<uint64_t, allocator_type>> vectors;
+		vectors.reserve(ops / length + 1);
+		std::vector<double> samples;
+		const double ns = timed_loop(ops, samples, [&](const size_t i) {
+			if (i % length == 0) vectors.emplace_back(alloc);
+			vectors.back().push_back(i);
+			/* keep the last few vectors, thus the arena does not start empty each time */
+			if (vectors.back().size() == length && vectors.size() > 4) {
+				vectors.erase(vectors.begin());
+			}
+		});
+		result r = make_result(ops, ns, samples);
+		r.fragmentation = heap.fragmentation();
+		return r;
+	}
+};
+
+struct map_churn
+{
+	size_t ops;
+
+	template <class Heap>
+	result operator ()(Heap & heap) const
+	{
+		typedef std::pair<const uint64_t, uint64_t> value_type;
+		typedef typename std::allocator_traits<typename Heap::allocator_type>::template rebind_alloc<value_type> allocator_type;
+		const size_t nkeys = 1 << 16;
+		uint64_t x = 88172645463325252ull;
+		std::map<uint64_t, uint64_t, std::less<uint64_t>, allocator_type> map(allocator_type(heap.get_allocator()));
+		std::vector<uint64_t> keys;
+		keys.reserve(nkeys);
+		while (keys.size() < nkeys) {
+			const uint64_t k = next_random(x);
+			if (map.emplace(k, k).second) keys.push_back(k);
+		}
+		std::vector<double> samples;
+		const double ns = timed_loop(ops, samples, [&](const size_t) {
+			const size_t j = next_random(x) % keys.size();
+			map.erase(keys[j]);
+			uint64_t k;
+			do {
+				k = next_random(x);
+			} while (!map.emplace(k, k).second);
+			keys[j] = k;
+		});
+		result r = make_result(ops, ns, samples);
+		r.fragmentation = heap.fragmentation();
+		return r;
+	}
+};
+
+/*
+ * Each event of the trace toggles a slot: it frees the block of the slot,
+ * or allocates a block of the size of the event. Thus half of the slots
+ * are used on average, there are enough slots for half of the arena.
+ */
+struct random_trace
+{
+	struct event
+	{
+		uint32_t slot;
+		uint32_t size;
+	};
+
+	size_t arena_bytes;
+	std::vector<event> events;
+
+	random_trace(const size_t ops, const size_t arena_bytes)
+		: arena_bytes(arena_bytes)
+	{
+		uint64_t x = 2463534242ull + arena_bytes;
+		const size_t limit = std::max(min_block_size, std::min(max_block_size, arena_bytes / 32));
+		uint64_t total = 0;
+		const size_t nsizes = 1 << 12;
+		for (size_t i = 0; i < nsizes; i++) total += random_size(x, limit);
+		const size_t slots = std::max<size_t>(1, arena_bytes / (total / nsizes));
+		/* enough events to reach the steady state */
+		events.resize(std::max(ops, 4 * slots));
+		for (auto & e : events) {
+			e.slot = next_random(x) % slots;
+			e.size = random_size(x, limit);
+		}
+	}
+
+	template <class Heap>
+	result operator ()(Heap & heap) const
+	{
+		typename Heap::allocator_type alloc(heap.get_allocator());
+		size_t nslots = 0;
+		for (const auto & e : events) nslots = std::max<size_t>(nslots, e.slot + 1);
+		std::vector<std::pair<char *, size_t>> live(nslots, std::make_pair(nullptr, 0));
+		size_t failed = 0;
+		std::vector<double> samples;
+		const double ns = timed_loop(events.size(), samples, [&](const size_t i) {
+			const event & e = events[i];
+			std::pair<char *, size_t> & slot = live[e.slot];
+			if (slot.first != nullptr) {
+				alloc.deallocate(slot.first, slot.second);
+				slot.first = nullptr;
+				return;
+			}
+			try {
+				slot.first = alloc.allocate(e.size);
+				slot.first[0] = 1;
+				slot.second = e.size;
+			} catch (const std::bad_alloc &) {
+				failed++;
+			}
+		});
+		result r = make_result(events.size(), ns, samples);
+		r.failed = failed;
+		r.fragmentation = heap.fragmentation();
+		for (auto & slot : live) {
+			if (slot.first != nullptr) alloc.deallocate(slot.first, slot.second);
+		}
+		return r;
+	}
+};
+
+/*
+ * The producer allocates blocks of random sizes and passes them
+ * through a ring to the consumer, which frees them.
+ */
+struct producer_consumer
+{
+	size_t ops;
+
+	template <class Heap>
+	result operator ()(Heap & heap) const
+	{
+		typedef typename Heap::allocator_type allocator_type;
+		typedef std::pair<char *, size_t> block;
+		const size_t capacity = 1024;
+		std::vector<block> ring(capacity);
+		std::atomic<size_t> head(0);
+		std::atomic<size_t> tail(0);
+		std::atomic<size_t> failed(0);
+		std::vector<double> produced;
+		std::vector<double> consumed;
+		produced.reserve(ops / sample_stride + 1);
+		consumed.reserve(ops / sample_stride + 1);
+
+		const clock_type::time_point start = clock_type::now();
+		std::thread consumer([&]() {
+			allocator_type alloc(heap.get_allocator());
+			for (size_t i = 0; i < ops; i++) {
+				while (head.load(std::memory_order_acquire) == tail.load(std::memory_order_relaxed)) {
+					std::this_thread::yield();
+				}
+				const block b = ring[tail.load(std::memory_order_relaxed) % capacity];
+				tail.store(tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+				if (b.first == nullptr) continue;
+				const clock_type::time_point t = clock_type::now();
+				alloc.deallocate(b.first, b.second);
+				if (i % sample_stride == 0) add_sample(consumed, t);
+			}
+		});
+		{
+			allocator_type alloc(heap.get_allocator());
+			uint64_t x = 1181783497276652981ull;
+			for (size_t i = 0; i < ops; i++) {
+				block b(nullptr, random_size(x, 512));
+				const clock_type::time_point t = clock_type::now();
+				try {
+					b.first = alloc.allocate(b.second);
+					b.first[0] = 1;
+				} catch (const std::bad_alloc &) {
+					failed++;
+				}
+				if (i % sample_stride == 0) add_sample(produced, t);
+				while (head.load(std::memory_order_relaxed) - tail.load(std::memory_order_acquire) == capacity) {
+					std::this_thread::yield();
+				}
+				ring[head.load(std::memory_order_relaxed) % capacity] = b;
+				head.store(head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+			}
+		}
+		consumer.join();
+		const double ns = elapsed_ns(start);
+
+		/* each block is one allocate and one deallocate */
+		produced.insert(produced.end(), consumed.begin(), consumed.end());
+		result r = make_result(2 * ops, ns, produced);
+		r.failed = failed;
+		r.fragmentation = heap.fragmentation();
+		return r;
+	}
+};
+
+template <class Heap, class Workload>
+void run(const char *const workload, const char *const name, const size_t arena_bytes, const Workload & w)
+{
+	reset_peak_rss();
+	result r;
+	{
+		Heap heap(name, arena_bytes);
+		r = w(heap);
+	}
+	std::cout << workload << "\t" << name << "\t" << arena_bytes << "\t" << r.ops
+		  << "\t" << r.ns_per_op << "\t" << r.p50_ns << "\t" << r.p99_ns << "\t" << r.failed
+		  << "\t" << peak_rss_kb() << "\t" << r.fragmentation << std::endl;
+}
+
+/* runs the workload with malloc, std::allocator and an arena of type Arena */
+template <class Arena, class Workload>
+void run_all(const char *const workload, const char *const arena_name, const size_t arena_bytes, const Workload & w)
+{
+	run<system_heap<malloc_allocator<char>>>(workload, "malloc", arena_bytes, w);
+	run<system_heap<std::allocator<char>>>(workload, "std::allocator", arena_bytes, w);
+	run<arena_heap<Arena>>(workload, arena_name, arena_bytes, w);
+}
+
+/**
+ * main function.
+ */
+int main(int argc, char **argv)
+{
+	const size_t ops = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 1 << 20;
+	const size_t max_arena_size = (argc > 2) ? std::strtoul(argv[2], nullptr, 10) : 1 << 30;
+	/* at least one operation and the smallest arena of random_trace */
+	if (argc > 3 || ops == 0 || max_arena_size < (1 << 10)) {
+		std::cerr << "usage: " << argv[0] << " [operations] [largest arena size in bytes]" << std::endl;
+		return 1;
+	}
+
+	calibrate_clock();
+	std::cout << "workload\tallocator\tarena_bytes\tops\tns_per_op\tp50_ns\tp99_ns\tfailed\tpeak_rss_kb\tfragmentation" << std::endl;
+
+	run_all<bitmap_arena>("vector_growth", "bitmap_arena", workload_arena_size, vector_growth{ops});
+	run_all<bitmap_arena>("map_churn", "bitmap_arena", workload_arena_size, map_churn{ops});
+	for (size_t arena_bytes = 1 << 10; arena_bytes <= max_arena_size; arena_bytes <<= 5) {
+		run_all<bitmap_arena>("random_trace", "bitmap_arena", arena_bytes, random_trace(ops, arena_bytes));
+	}
+	run_all<concurrent_arena>("producer_consumer", "concurrent_arena", workload_arena_size, producer_consumer{ops});
+	return 0;
+}
@@ -0,0 +1,110 @@
+#include "StaticMemoryAllocator/allocator.hpp"
+#include "StaticMemoryAllocator/tlsf_arena.hpp"
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstdlib>
+#include <chrono>
+
+/**
+ * Benchmark of allocating and deallocating many nodes of a fixed size
+ * one by one (allocate()/deallocate()) and in one batch
+ * (allocate_batch()/deallocate_batch()), using the bitmap_arena,
+ * the concurrent_arena and the tlsf_arena (which has no batch functions,
+ * thus the allocator falls back to single allocations).
+ *
+ * Columns: arena, nodes, single_alloc_ns, batch_alloc_ns, single_free_ns, batch_free_ns
+ * (all per node).
+ *
+ * usage: batch_alloc [nodes] [rounds]
+ */
+
+struct node
+{
+	node *next;
+	uint64_t key;
+	uint64_t value;
+};
+
+static const size_t granule = 16;
+
+typedef StaticMemoryAllocator::bitmap_arena<granule>     bitmap_arena;
+typedef StaticMemoryAllocator::concurrent_arena<granule> concurrent_arena;
+
+#include "StaticMemoryAllocator/allocator_impl.hpp"
+template class StaticMemoryAllocator::allocator<node, bitmap_arena>;
+template class StaticMemoryAllocator::allocator<node, concurrent_arena>;
+template class StaticMemoryAllocator::allocator<node, StaticMemoryAllocator::tlsf_arena>;
+
+struct result
+{
+	double single_alloc_ns;
+	double batch_alloc_ns;
+	double single_free_ns;
+	double batch_free_ns;
+};
+
+template <class Arena>
+result run(Arena & arena, const size_t n, const size_t rounds)
+{
+	typedef std::chrono::steady_clock clock;
+	typedef std::chrono::duration<double, std::nano> ns;
+	StaticMemoryAllocator::allocator<node, Arena> alloc(arena);
+	std::vector<node *> nodes(n);
+	result r = {0, 0, 0, 0};
+	for (size_t round = 0; round < rounds; round++) {
+		auto t0 = clock::now();
+		for (size_t i = 0; i < n; i++) nodes[i] = alloc.allocate(1);
+		auto t1 = clock::now();
+		for (size_t i = 0; i < n; i++) alloc.deallocate(nodes[i], 1);
+		auto t2 = clock::now();
+		alloc.allocate_batch(n, 1, nodes.data());
+		auto t3 = clock::now();
+		alloc.deallocate_batch(nodes.data(), n, 1);
+		auto t4 = clock::now();
+		r.single_alloc_ns += ns(t1 - t0).count();
+		r.single_free_ns += ns(t2 - t1).count();
+		r.batch_alloc_ns += ns(t3 - t2).count();
+		r.batch_free_ns += ns(t4 - t3).count();
+	}
+	r.single_alloc_ns /= n * rounds;
+	r.batch_alloc_ns /= n * rounds;
+	r.single_free_ns /= n * rounds;
+	r.batch_free_ns /= n * rounds;
+	return r;
+}
+
+void print(const std::string & name, const size_t n, const result & r)
+{
+	std::cout << name << "\t" << n << "\t"
+		  << r.single_alloc_ns << "\t" << r.batch_alloc_ns << "\t"
+		  << r.single_free_ns << "\t" << r.batch_free_ns << std::endl;
+}
+
+/**
+ * main function.
+ */
+int main(int argc, char **argv)
+{
+	const size_t n = (argc > 1) ? std::atol(argv[1]) : 100000;
+	const size_t rounds = (argc > 2) ? std::atol(argv[2]) : 20;
+	const size_t memsize = 2 * sizeof(node) * n + (1 << 20);
+	std::vector<uint8_t> mem(memsize);
+
+	std::cout << "arena\tnodes\tsingle_alloc_ns\tbatch_alloc_ns\tsingle_free_ns\tbatch_free_ns" << std::endl;
+	{
+		bitmap_arena arena(mem.data(), mem.size(), "bitmap");
+		print("bitmap_arena", n, run(arena, n, rounds));
+	}
+	{
+		concurrent_arena arena(mem.data(), mem.size(), "concurrent");
+		print("concurrent_arena", n, run(arena, n, rounds));
+	}
+	{
+		StaticMemoryAllocator::tlsf_arena arena(mem.data(), mem.size(), "tlsf");
+		print("tlsf_arena", n, run(arena, n, rounds));
+	}
+	return 0;
+}
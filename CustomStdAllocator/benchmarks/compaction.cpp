@@ -0,0 +1,87 @@
+#include "StaticMemoryAllocator/compacting_arena.hpp"
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstdlib>
+#include <chrono>
+
+/**
+ * Benchmark of compacting a fragmented compacting_arena.
+ *
+ * The arena is filled with blocks of random sizes (16 to 1024 bytes),
+ * then every other block (in a random order) is freed, thus the largest
+ * free block is small although half of the memory is free.
+ * compact() moves the remaining blocks together.
+ *
+ * Columns: arena_mb, live_blocks, moved_mb, compact_ms, ms_per_moved_mb,
+ * largest_free_kb_before, largest_free_kb_after.
+ *
+ * usage: compaction [largest arena size in MB]
+ */
+
+static const size_t granule = 16;
+
+typedef StaticMemoryAllocator::compacting_arena<granule> arena_type;
+typedef StaticMemoryAllocator::handle<uint8_t>           handle_type;
+
+#include "StaticMemoryAllocator/compacting_arena_impl.hpp"
+template class StaticMemoryAllocator::compacting_arena<granule>;
+
+static uint64_t next_random(uint64_t & x)
+{
+	x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+	return x;
+}
+
+void run(const size_t mb)
+{
+	typedef std::chrono::steady_clock clock;
+	std::vector<uint8_t> mem(mb << 20);
+	arena_type arena(mem.data(), mem.size(), "compacting");
+	uint64_t x = 88172645463325252ull;
+	std::vector<handle_type> blocks;
+	for (;;) {
+		const size_t nb = 16 + next_random(x) % 1009;
+		const handle_type h = arena.allocate<uint8_t>(nb);
+		if (!h) break;
+		h[0] = static_cast<uint8_t>(nb);
+		blocks.push_back(h);
+	}
+	std::vector<handle_type> live;
+	for (size_t i = 0; i < blocks.size(); i++) {
+		if (next_random(x) % 2) {
+			arena.deallocate(blocks[i]);
+		} else {
+			live.push_back(blocks[i]);
+		}
+	}
+	const size_t before = arena.max_size();
+
+	const auto start = clock::now();
+	const size_t moved = arena.compact();
+	const std::chrono::duration<double, std::milli> d = clock::now() - start;
+
+	/* keeps the moves from being optimized away */
+	size_t sum = 0;
+	for (const auto & h : live) sum += h[0];
+	if (sum == 42) std::cerr << sum << std::endl;
+
+	const double moved_mb = static_cast<double>(moved) / (1 << 20);
+	std::cout << mb << "\t" << live.size() << "\t" << moved_mb << "\t" << d.count() << "\t"
+		  << d.count() / moved_mb << "\t" << before / 1024 << "\t" << arena.max_size() / 1024 << std::endl;
+}
+
+/**
+ * main function.
+ */
+int main(int argc, char **argv)
+{
+	const size_t max_mb = (argc > 1) ? std::atol(argv[1]) : 256;
+	std::cout << "arena_mb\tlive_blocks\tmoved_mb\tcompact_ms\tms_per_moved_mb\tlargest_free_kb_before\tlargest_free_kb_after" << std::endl;
+	for (size_t mb = 1; mb <= max_mb; mb *= 4) {
+		run(mb);
+	}
+	return 0;
+}
@@ -0,0 +1,161 @@
+#include "StaticMemoryAllocator/allocator.hpp"
+#include "StaticMemoryAllocator/thread_cached_arena.hpp"
+
+#include <memory>
+#include <algorithm>
+#include <functional>
+#include <iostream>
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <thread>
+#include <mutex>
+#include <chrono>
+
+/**
+ * Scaling benchmark of an arena shared by 1 to N threads:
+ * the lock-free concurrent_arena (with and without caches per thread)
+ * against a bitmap_arena, which is protected by one global mutex.
+ *
+ * Each thread keeps a window of live blocks of random sizes,
+ * each operation frees the oldest block of the window and allocates a new one.
+ *
+ * usage: concurrent_scaling [max threads] [operations per thread]
+ */
+
+static const size_t granule = 16;
+
+typedef StaticMemoryAllocator::concurrent_arena<granule>  lock_free_arena;
+typedef StaticMemoryAllocator::bitmap_arena<granule>      locked_arena;
+typedef StaticMemoryAllocator::thread_cached_arena<lock_free_arena> cached_arena;
+
+typedef StaticMemoryAllocator::allocator<char, lock_free_arena> lock_free_allocator;
+typedef StaticMemoryAllocator::allocator<char, locked_arena>    locked_allocator;
+typedef StaticMemoryAllocator::allocator<char, cached_arena>    cached_allocator;
+
+#include "StaticMemoryAllocator/allocator_impl.hpp"
+#include "StaticMemoryAllocator/thread_cached_arena_impl.hpp"
+template class StaticMemoryAllocator::allocator<char, lock_free_arena>;
+template class StaticMemoryAllocator::allocator<char, locked_arena>;
+template class StaticMemoryAllocator::allocator<char, cached_arena>;
+
+static const size_t window = 32;
+static const size_t max_block_size = 256;
+
+class lock_free_heap
+{
+public:
+	lock_free_heap(void *const memstart, const size_t memsize)
+		: arena(memstart, memsize, "lock-free"),
+		  alloc(arena)
+	{}
+
+	char *allocate(const size_t n) { return alloc.allocate(n); }
+
+	void deallocate(char *const p, const size_t n) { alloc.deallocate(p, n); }
+
+private:
+	lock_free_arena arena;
+	lock_free_allocator alloc;
+};
+
+class cached_heap
+{
+public:
+	cached_heap(void *const memstart, const size_t memsize)
+		: arena(memstart, memsize, "cached"),
+		  alloc(arena)
+	{}
+
+	char *allocate(const size_t n) { return alloc.allocate(n); }
+
+	void deallocate(char *const p, const size_t n) { alloc.deallocate(p, n); }
+
+private:
+	cached_arena arena;
+	cached_allocator alloc;
+};
+
+class mutex_heap
+{
+public:
+	mutex_heap(void *const memstart, const size_t memsize)
+		: arena(memstart, memsize, "mutex"),
+		  alloc(arena)
+	{}
+
+	char *allocate(const size_t n)
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		return alloc.allocate(n);
+	}
+
+	void deallocate(char *const p, const size_t n)
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		alloc.deallocate(p, n);
+	}
+
+private:
+	std::mutex mutex;
+	locked_arena arena;
+	locked_allocator alloc;
+};
+
+template <class Heap>
+void worker(Heap & heap, const size_t ops, const unsigned seed)
+{
+	std::vector<std::pair<char *, size_t>> live(window, std::make_pair(nullptr, 0));
+	uint32_t x = seed * 2654435761u + 1;
+	for (size_t i = 0; i < ops; i++) {
+		std::pair<char *, size_t> & slot = live[i % window];
+		if (slot.first != nullptr) heap.deallocate(slot.first, slot.second);
+		x ^= x << 13; x ^= x >> 17; x ^= x << 5;
+		slot.second = 1 + x % max_block_size;
+		slot.first = heap.allocate(slot.second);
+	}
+	for (auto & slot : live) {
+		if (slot.first != nullptr) heap.deallocate(slot.first, slot.second);
+	}
+}
+
+/* returns the throughput in million operations per second */
+template <class Heap>
+double run(const unsigned nthreads, const size_t ops)
+{
+	/* twice the memory of all live (and cached) blocks, thus there is always enough free memory */
+	const size_t memsize = 2 * nthreads * (window + 2 * max_block_size) * (max_block_size + granule);
+	std::vector<uint8_t> mem(memsize);
+	Heap heap(mem.data(), mem.size());
+	std::vector<std::thread> threads;
+	const auto start = std::chrono::steady_clock::now();
+	for (unsigned t = 0; t < nthreads; t++) {
+		threads.emplace_back(worker<Heap>, std::ref(heap), ops, t + 1);
+	}
+	for (auto & thread : threads) thread.join();
+	const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+	/* each operation is one allocate and one deallocate */
+	return (nthreads * ops) / elapsed.count() / 1e6;
+}
+
+/**
+ * main function.
+ */
+int main(int argc, char **argv)
+{
+	const unsigned max_threads = (argc > 1) ? std::atoi(argv[1])
+		: std::max(1u, std::thread::hardware_concurrency());
+	const size_t ops = (argc > 2) ? std::atol(argv[2]) : 200000;
+
+	std::cout << "threads\tlock_free_mops\tcached_mops\tmutex_mops" << std::endl;
+	for (unsigned nthreads = 1; ; nthreads = std::min(2 * nthreads, max_threads)) {
+		const double lock_free = run<lock_free_heap>(nthreads, ops);
+		const double cached = run<cached_heap>(nthreads, ops);
+		const double mutex = run<mutex_heap>(nthreads, ops);
+		std::cout << nthreads << "\t" << lock_free << "\t" << cached << "\t" << mutex << std::endl;
+		if (nthreads >= max_threads) break;
+	}
+	return 0;
+}
@@ -0,0 +1,104 @@
+#include "StaticMemoryAllocator/allocator.hpp"
+#include "StaticMemoryAllocator/vector.hpp"
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstdlib>
+#include <chrono>
+
+/**
+ * Benchmark of move assignments and swaps of std::vector and
+ * StaticMemoryAllocator::vector using the allocator, of vectors of the same
+ * arena and of two different arenas.
+ *
+ * Since the allocator propagates on move assignment and swap, both only
+ * swap pointers, independent of the number of elements
+ * (data_moved tells, whether the elements were ever moved to another block).
+ *
+ * Columns: vector, arenas, elements, move_assign_ns, swap_ns, data_moved.
+ *
+ * usage: container_moves [repetitions]
+ */
+
+typedef uint64_t value_type;
+
+static const size_t granule = 16;
+
+typedef StaticMemoryAllocator::bitmap_arena<granule>                arena_type;
+typedef StaticMemoryAllocator::allocator<value_type, arena_type>    value_allocator;
+typedef std::vector<value_type, value_allocator>                    std_vector;
+typedef StaticMemoryAllocator::vector<value_type, value_allocator>  static_vector;
+
+#include "StaticMemoryAllocator/allocator_impl.hpp"
+#include "StaticMemoryAllocator/vector_impl.hpp"
+template class StaticMemoryAllocator::allocator<value_type, arena_type>;
+template class StaticMemoryAllocator::vector<value_type, value_allocator>;
+
+struct result
+{
+	double move_ns;
+	double swap_ns;
+	bool moved;
+};
+
+template <class Vector>
+result run(arena_type & arena1, arena_type & arena2, const size_t n, const size_t repetitions)
+{
+	typedef std::chrono::steady_clock clock;
+	Vector v1{value_allocator(arena1)};
+	Vector v2{value_allocator(arena2)};
+	v1.resize(n, 1);
+	v2.resize(n, 2);
+	const value_type *const data1 = v1.data();
+	const value_type *const data2 = v2.data();
+
+	const auto start = clock::now();
+	for (size_t i = 0; i < repetitions; i++) {
+		Vector tmp(std::move(v1));
+		v1 = std::move(v2);
+		v2 = std::move(tmp);
+	}
+	const auto moved = clock::now();
+	for (size_t i = 0; i < repetitions; i++) {
+		v1.swap(v2);
+	}
+	const auto swapped = clock::now();
+
+	const std::chrono::duration<double, std::nano> move = moved - start;
+	const std::chrono::duration<double, std::nano> swap = swapped - moved;
+	result r;
+	/* a move construction and two move assignments per repetition */
+	r.move_ns = move.count() / (3 * repetitions);
+	r.swap_ns = swap.count() / repetitions;
+	r.moved = !((v1.data() == data1 && v2.data() == data2) || (v1.data() == data2 && v2.data() == data1));
+	return r;
+}
+
+void print(const std::string & name, const std::string & arenas, const size_t n, const result & r)
+{
+	std::cout << name << "\t" << arenas << "\t" << n << "\t" << r.move_ns << "\t" << r.swap_ns << "\t" << (r.moved ? "yes" : "no") << std::endl;
+}
+
+/**
+ * main function.
+ */
+int main(int argc, char **argv)
+{
+	const size_t repetitions = (argc > 1) ? std::atol(argv[1]) : 1000000;
+	const size_t max_elements = 100000;
+	const size_t memsize = 4 * max_elements * sizeof(value_type);
+	std::vector<uint8_t> mem1(memsize), mem2(memsize);
+	arena_type arena1(mem1.data(), mem1.size(), "arena1");
+	arena_type arena2(mem2.data(), mem2.size(), "arena2");
+
+	std::cout << "vector\tarenas\telements\tmove_assign_ns\tswap_ns\tdata_moved" << std::endl;
+	for (size_t n = 10; n <= max_elements; n *= 100) {
+		print("std::vector", "same", n, run<std_vector>(arena1, arena1, n, repetitions));
+		print("std::vector", "different", n, run<std_vector>(arena1, arena2, n, repetitions));
+		print("sma::vector", "same", n, run<static_vector>(arena1, arena1, n, repetitions));
+		print("sma::vector", "different", n, run<static_vector>(arena1, arena2, n, repetitions));
+	}
+	return 0;
+}
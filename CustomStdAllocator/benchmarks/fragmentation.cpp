@@ -0,0 +1,218 @@
+#include "StaticMemoryAllocator/arena.hpp"
+#include "StaticMemoryAllocator/buddy_arena.hpp"
+#include "StaticMemoryAllocator/tlsf_arena.hpp"
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstdlib>
+#include <chrono>
+
+/**
+ * Fragmentation and throughput of the bitmap_arena (first fit),
+ * the tlsf_arena and the buddy_arena on the same allocation traces:
+ *
+ * - vector_growth: vectors growing by doubling their capacity
+ *   (allocate the new buffer, then free the old one), which are
+ *   destroyed and started again at random.
+ * - pow2_buffers: buffers of 16 bytes to 16 KiB (powers of two),
+ *   allocated and freed at random.
+ * - mixed_sizes: buffers of 1 byte to 4 KiB (any size),
+ *   allocated and freed at random.
+ *
+ * Each trace is replayed twice per arena: in a large memory block
+ * (ns_per_op), and in a memory block of \p tight times the peak of the
+ * live bytes of the trace, where allocations fail due to fragmentation
+ * and rounding (failed_pct: failed allocations, fill_at_first_fail:
+ * live bytes in percent of the memory block at the first failure,
+ * or '-' if no allocation failed).
+ *
+ * usage: fragmentation [operations] [tight]
+ */
+
+typedef StaticMemoryAllocator::bitmap_arena<16> bitmap_arena;
+typedef StaticMemoryAllocator::tlsf_arena       tlsf_arena;
+typedef StaticMemoryAllocator::buddy_arena      buddy_arena;
+
+#include "StaticMemoryAllocator/arena_impl.hpp"
+template class StaticMemoryAllocator::bitmap_arena<16>;
+
+struct operation
+{
+	/* allocate or free the block with the id */
+	bool allocate;
+	size_t id;
+	size_t nb;
+};
+
+struct trace
+{
+	std::string name;
+	std::vector<operation> ops;
+	size_t nids;
+	size_t peak_live;
+};
+
+struct result
+{
+	double ns_per_op;
+	double failed_pct;
+	double fill_at_first_fail;
+};
+
+static uint64_t next_random(uint64_t & x)
+{
+	x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+	return x;
+}
+
+/* tracks the live bytes of a trace while it is generated */
+struct trace_builder
+{
+	explicit trace_builder(const std::string & name)
+		: live(0)
+	{
+		t.name = name;
+		t.nids = 0;
+		t.peak_live = 0;
+	}
+
+	size_t allocate(const size_t nb)
+	{
+		const size_t id = t.nids++;
+		t.ops.push_back(operation{true, id, nb});
+		sizes.push_back(nb);
+		live += nb;
+		if (live > t.peak_live) t.peak_live = live;
+		return id;
+	}
+
+	void deallocate(const size_t id)
+	{
+		t.ops.push_back(operation{false, id, sizes[id]});
+		live -= sizes[id];
+	}
+
+	trace t;
+	std::vector<size_t> sizes;
+	size_t live;
+};
+
+static trace vector_growth(const size_t nops)
+{
+	trace_builder b("vector_growth");
+	uint64_t x = 88172645463325252ull;
+	const size_t nvectors = 64;
+	const size_t max_bytes = 64 * 1024;
+	std::vector<size_t> ids(nvectors), bytes(nvectors, 8);
+	for (size_t v = 0; v < nvectors; v++) ids[v] = b.allocate(bytes[v]);
+	while (b.t.ops.size() < nops) {
+		const size_t v = next_random(x) % nvectors;
+		if (bytes[v] < max_bytes && next_random(x) % 8 != 0) {
+			/* grow: the new buffer is allocated, before the old one is freed */
+			const size_t id = b.allocate(2 * bytes[v]);
+			b.deallocate(ids[v]);
+			ids[v] = id;
+			bytes[v] *= 2;
+		} else {
+			b.deallocate(ids[v]);
+			bytes[v] = 8;
+			ids[v] = b.allocate(bytes[v]);
+		}
+	}
+	for (size_t v = 0; v < nvectors; v++) b.deallocate(ids[v]);
+	return b.t;
+}
+
+static trace random_buffers(const std::string & name, const size_t nops, const bool pow2)
+{
+	trace_builder b(name);
+	uint64_t x = 2463534242ull;
+	const size_t nlive = 512;
+	std::vector<size_t> ids;
+	while (b.t.ops.size() < nops) {
+		if (ids.size() < nlive && (ids.empty() || next_random(x) % 2 == 0)) {
+			const size_t nb = pow2 ? (size_t(16) << (next_random(x) % 11)) : 1 + next_random(x) % 4096;
+			ids.push_back(b.allocate(nb));
+		} else {
+			const size_t i = next_random(x) % ids.size();
+			b.deallocate(ids[i]);
+			ids[i] = ids.back();
+			ids.pop_back();
+		}
+	}
+	for (size_t i = 0; i < ids.size(); i++) b.deallocate(ids[i]);
+	return b.t;
+}
+
+template <class Arena>
+result replay(const trace & t, const size_t memsize)
+{
+	typedef std::chrono::steady_clock clock;
+	std::vector<uint8_t> mem(memsize);
+	Arena arena(mem.data(), mem.size());
+	std::vector<void *> blocks(t.nids, nullptr);
+	size_t live = 0, failed = 0, nallocs = 0;
+	double fill = -1.0;
+
+	const auto start = clock::now();
+	for (size_t i = 0; i < t.ops.size(); i++) {
+		const operation & op = t.ops[i];
+		if (op.allocate) {
+			nallocs++;
+			blocks[op.id] = arena.allocate(op.nb, 16);
+			if (blocks[op.id] != nullptr) {
+				live += op.nb;
+			} else if (failed++ == 0) {
+				fill = 100.0 * live / arena.size();
+			}
+		} else if (blocks[op.id] != nullptr) {
+			arena.deallocate(blocks[op.id], op.nb);
+			live -= op.nb;
+		}
+	}
+	const auto stop = clock::now();
+
+	const std::chrono::duration<double, std::nano> elapsed = stop - start;
+	result r;
+	r.ns_per_op = elapsed.count() / t.ops.size();
+	r.failed_pct = 100.0 * failed / nallocs;
+	r.fill_at_first_fail = fill;
+	return r;
+}
+
+template <class Arena>
+void run(const std::string & name, const trace & t, const double tight)
+{
+	const result fast = replay<Arena>(t, 4 * t.peak_live + (1 << 20));
+	const result frag = replay<Arena>(t, static_cast<size_t>(tight * t.peak_live));
+	std::cout << t.name << "\t" << name << "\t" << fast.ns_per_op << "\t" << frag.failed_pct << "\t";
+	if (frag.fill_at_first_fail < 0) {
+		std::cout << "-" << std::endl;
+	} else {
+		std::cout << frag.fill_at_first_fail << std::endl;
+	}
+}
+
+/**
+ * main function.
+ */
+int main(int argc, char **argv)
+{
+	const size_t nops = (argc > 1) ? std::atol(argv[1]) : 1000000;
+	const double tight = (argc > 2) ? std::atof(argv[2]) : 1.0;
+
+	std::vector<trace> traces;
+	traces.push_back(vector_growth(nops));
+	traces.push_back(random_buffers("pow2_buffers", nops, true));
+	traces.push_back(random_buffers("mixed_sizes", nops, false));
+
+	std::cout << "trace\tarena\tns_per_op\tfailed_pct\tfill_at_first_fail" << std::endl;
+	for (size_t i = 0; i < traces.size(); i++) {
+		run<bitmap_arena>("bitmap_arena", traces[i], tight);
+		run<tlsf_arena>("tlsf_arena", traces[i], tight);
+		run<buddy_arena>("buddy_arena", traces[i], tight);
+	}
+	return 0;
+}
@@ -0,0 +1,149 @@
+#include "StaticMemoryAllocator/allocator.hpp"
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstdlib>
+#include <chrono>
+
+/**
+ * Benchmark of the locality of linked lists, whose nodes are allocated
+ * with and without the previous node as hint.
+ *
+ * The managed memory block is fragmented first (blocks of random sizes
+ * are allocated, then every second one is freed). Then the nodes of
+ * several lists are appended in random order, and the lists are used
+ * as queues for a while (the first node of a random list is freed, a
+ * new node is appended to it). Without a hint, a new node is placed in
+ * the first hole (first fit), wherever its predecessor is. Finally
+ * each list is traversed (pointer chasing).
+ *
+ * Columns: placement, traverse_ns_per_node, mean_node_distance (bytes
+ * between two neighbouring nodes of a list).
+ *
+ * usage: hint_locality [nodes] [lists] [traversals] [queue operations]
+ */
+
+struct node
+{
+	node *next;
+	uint64_t value;
+	uint64_t padding;
+};
+
+static const size_t granule = 16;
+
+typedef StaticMemoryAllocator::bitmap_arena<granule>              arena_type;
+typedef StaticMemoryAllocator::allocator<node, arena_type>        node_allocator;
+typedef StaticMemoryAllocator::allocator<uint8_t, arena_type>     filler_allocator;
+
+#include "StaticMemoryAllocator/allocator_impl.hpp"
+template class StaticMemoryAllocator::allocator<node, arena_type>;
+template class StaticMemoryAllocator::allocator<uint8_t, arena_type>;
+
+struct result
+{
+	double traverse_ns;
+	double mean_distance;
+};
+
+static uint64_t next_random(uint64_t & x)
+{
+	x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+	return x;
+}
+
+static void fragment(filler_allocator & filler, const size_t memsize)
+{
+	uint64_t x = 2463534242ull;
+	std::vector<std::pair<uint8_t *, size_t>> blocks;
+	size_t used = 0;
+	while (used < memsize / 4 * 3) {
+		const size_t nb = 16 + next_random(x) % 241;
+		blocks.push_back(std::make_pair(filler.allocate(nb), nb));
+		used += nb;
+	}
+	for (size_t i = 0; i < blocks.size(); i += 2) {
+		filler.deallocate(blocks[i].first, blocks[i].second);
+	}
+}
+
+static result run(const bool use_hint, const size_t nnodes, const size_t nlists, const size_t ntraversals, const size_t nqueue)
+{
+	typedef std::chrono::steady_clock clock;
+	const size_t memsize = 16 * nnodes * sizeof(node) + (1 << 20);
+	std::vector<uint8_t> mem(memsize);
+	arena_type arena(mem.data(), mem.size(), use_hint ? "hint" : "first_fit");
+	node_allocator alloc(arena);
+	filler_allocator filler(alloc);
+	fragment(filler, memsize);
+
+	uint64_t x = 88172645463325252ull;
+	std::vector<node *> heads(nlists, nullptr), tails(nlists, nullptr);
+	for (size_t i = 0; i < nnodes + nqueue; i++) {
+		const size_t l = next_random(x) % nlists;
+		if (i >= nnodes && heads[l] != nullptr && heads[l] != tails[l]) {
+			node *const head = heads[l];
+			heads[l] = head->next;
+			alloc.deallocate(head, 1);
+		}
+		node *const n = alloc.allocate(1, use_hint ? tails[l] : nullptr);
+		n->next = nullptr;
+		n->value = i;
+		if (tails[l] != nullptr) {
+			tails[l]->next = n;
+		} else {
+			heads[l] = n;
+		}
+		tails[l] = n;
+	}
+
+	size_t count = 0;
+	double distance = 0;
+	for (size_t l = 0; l < nlists; l++) {
+		for (const node *n = heads[l]; n != nullptr && n->next != nullptr; n = n->next) {
+			const intptr_t d = reinterpret_cast<intptr_t>(n->next) - reinterpret_cast<intptr_t>(n);
+			distance += (d < 0) ? -d : d;
+		}
+		for (const node *n = heads[l]; n != nullptr; n = n->next) count++;
+	}
+
+	uint64_t sum = 0;
+	const auto start = clock::now();
+	for (size_t t = 0; t < ntraversals; t++) {
+		for (size_t l = 0; l < nlists; l++) {
+			for (const node *n = heads[l]; n != nullptr; n = n->next) sum += n->value;
+		}
+	}
+	const auto stop = clock::now();
+	/* the sum is used, thus the traversal is not optimized away */
+	if (sum == 0 && count > 1) std::cerr << "unexpected sum" << std::endl;
+
+	const std::chrono::duration<double, std::nano> elapsed = stop - start;
+	result r;
+	r.traverse_ns = elapsed.count() / (count * ntraversals);
+	r.mean_distance = (count > nlists) ? distance / (count - nlists) : 0;
+	return r;
+}
+
+void print(const std::string & name, const result & r)
+{
+	std::cout << name << "\t" << r.traverse_ns << "\t" << r.mean_distance << std::endl;
+}
+
+/**
+ * main function.
+ */
+int main(int argc, char **argv)
+{
+	const size_t nnodes = (argc > 1) ? std::atol(argv[1]) : 200000;
+	const size_t nlists = (argc > 2) ? std::atol(argv[2]) : 64;
+	const size_t ntraversals = (argc > 3) ? std::atol(argv[3]) : 20;
+	const size_t nqueue = (argc > 4) ? std::atol(argv[4]) : 4 * nnodes;
+
+	std::cout << "placement\ttraverse_ns_per_node\tmean_node_distance" << std::endl;
+	print("first_fit", run(false, nnodes, nlists, ntraversals, nqueue));
+	print("hint", run(true, nnodes, nlists, ntraversals, nqueue));
+	return 0;
+}
@@ -0,0 +1,122 @@
+#include "StaticMemoryAllocator/allocator.hpp"
+#include "StaticMemoryAllocator/mapped_arena.hpp"
+
+#include <memory>
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <chrono>
+
+/**
+ * Benchmark of a large arena in anonymous_memory with normal pages
+ * and with transparent huge pages, each with and without prefaulting.
+ *
+ * The arena is split into page sized blocks (by allocate_batch),
+ * then the first byte of each block is written (first touch), then
+ * random bytes are read, each read depending on the one before
+ * (i.e., the latency of the accesses including TLB misses).
+ *
+ * Columns: pages, prefault, setup_ms (mapping and prefaulting),
+ * first_touch_ns (per block), random_access_ns (per read),
+ * anon_huge_kb (memory of the process in huge pages).
+ *
+ * usage: huge_pages [arena size in MB] [random reads]
+ */
+
+typedef StaticMemoryAllocator::anonymous_memory anonymous_memory;
+typedef StaticMemoryAllocator::bitmap_arena<> arena_type;
+typedef StaticMemoryAllocator::allocator<uint8_t, arena_type> allocator_type;
+
+#include "StaticMemoryAllocator/allocator_impl.hpp"
+template class StaticMemoryAllocator::allocator<uint8_t, arena_type>;
+
+static const size_t block_size = 4096;
+
+struct result
+{
+	double setup_ms;
+	double first_touch_ns;
+	double random_access_ns;
+	size_t anon_huge_kb;
+};
+
+static uint64_t next_random(uint64_t & x)
+{
+	x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+	return x;
+}
+
+static size_t anon_huge_kb(void)
+{
+	std::ifstream smaps("/proc/self/smaps_rollup");
+	std::string line;
+	while (std::getline(smaps, line)) {
+		if (line.compare(0, 14, "AnonHugePages:") == 0) return std::strtoul(line.c_str() + 14, nullptr, 10);
+	}
+	return 0;
+}
+
+result run(const size_t memsize, const unsigned flags, const size_t reads)
+{
+	typedef std::chrono::steady_clock clock;
+	result r;
+
+	const auto start = clock::now();
+	anonymous_memory mem(memsize, flags);
+	const std::chrono::duration<double, std::milli> setup = clock::now() - start;
+	r.setup_ms = setup.count();
+
+	arena_type arena(mem.data(), mem.size(), "anonymous");
+	allocator_type alloc(arena);
+	const size_t nblocks = mem.size() / block_size;
+	std::vector<uint8_t *> blocks(nblocks);
+	alloc.allocate_batch(nblocks, block_size, blocks.data());
+
+	const auto touch = clock::now();
+	for (size_t i = 0; i < nblocks; i++) blocks[i][0] = static_cast<uint8_t>(i);
+	const std::chrono::duration<double, std::nano> touched = clock::now() - touch;
+	r.first_touch_ns = touched.count() / nblocks;
+
+	uint64_t x = 88172645463325252ull;
+	const auto access = clock::now();
+	for (size_t i = 0; i < reads; i++) {
+		const uint64_t v = next_random(x);
+		const uint8_t b = blocks[v % nblocks][(v >> 32) % block_size];
+		/* the next address depends on the value read */
+		x ^= b;
+	}
+	const std::chrono::duration<double, std::nano> accessed = clock::now() - access;
+	/* keeps the reads */
+	blocks[0][1] = static_cast<uint8_t>(x);
+	r.random_access_ns = accessed.count() / reads;
+	r.anon_huge_kb = anon_huge_kb();
+
+	alloc.deallocate_batch(blocks.data(), nblocks, block_size);
+	return r;
+}
+
+void print(const std::string & pages, const bool prefault, const result & r)
+{
+	std::cout << pages << "\t" << (prefault ? "yes" : "no") << "\t" << r.setup_ms << "\t"
+		  << r.first_touch_ns << "\t" << r.random_access_ns << "\t" << r.anon_huge_kb << std::endl;
+}
+
+/**
+ * main function.
+ */
+int main(int argc, char **argv)
+{
+	const size_t memsize = ((argc > 1) ? std::atol(argv[1]) : 512) << 20;
+	const size_t reads = (argc > 2) ? std::atol(argv[2]) : 1 << 22;
+
+	std::cout << "pages\tprefault\tsetup_ms\tfirst_touch_ns\trandom_access_ns\tanon_huge_kb" << std::endl;
+	print("normal", false, run(memsize, anonymous_memory::none, reads));
+	print("normal", true, run(memsize, anonymous_memory::prefault, reads));
+	print("huge", false, run(memsize, anonymous_memory::huge_pages, reads));
+	print("huge", true, run(memsize, anonymous_memory::huge_pages | anonymous_memory::prefault, reads));
+	return 0;
+}
@@ -0,0 +1,121 @@
+#include "StaticMemoryAllocator/allocator.hpp"
+#include "StaticMemoryAllocator/slab_arena.hpp"
+
+#include <memory>
+#include <iostream>
+#include <vector>
+#include <map>
+#include <string>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <chrono>
+#include <functional>
+
+/**
+ * Benchmark of std::map inserts and erases (i.e., node allocations)
+ * using std::allocator, the bitmap_arena and the slab_arena.
+ *
+ * The map is filled with n random keys, then for each churn operation
+ * a random key is erased and a new one is inserted.
+ *
+ * usage: map_churn [keys] [churn operations]
+ */
+
+typedef uint64_t key_type;
+typedef uint64_t mapped_type;
+typedef std::pair<const key_type, mapped_type> value_type;
+
+static const size_t granule = 16;
+
+typedef StaticMemoryAllocator::bitmap_arena<granule>      bitmap_arena;
+typedef StaticMemoryAllocator::slab_arena<bitmap_arena>   slab_arena;
+
+typedef StaticMemoryAllocator::allocator<value_type, bitmap_arena> bitmap_allocator;
+typedef StaticMemoryAllocator::allocator<value_type, slab_arena>   slab_allocator;
+
+#include "StaticMemoryAllocator/allocator_impl.hpp"
+#include "StaticMemoryAllocator/slab_arena_impl.hpp"
+template class StaticMemoryAllocator::allocator<value_type, bitmap_arena>;
+template class StaticMemoryAllocator::allocator<value_type, slab_arena>;
+
+struct result
+{
+	double insert_ns;
+	double churn_ns;
+};
+
+static uint64_t next_random(uint64_t & x)
+{
+	x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+	return x;
+}
+
+template <class Map>
+result run(Map & map, const size_t nkeys, const size_t nchurn)
+{
+	typedef std::chrono::steady_clock clock;
+	uint64_t x = 88172645463325252ull;
+	std::vector<key_type> keys;
+	keys.reserve(nkeys);
+
+	const auto start = clock::now();
+	while (keys.size() < nkeys) {
+		const key_type k = next_random(x);
+		if (map.emplace(k, k).second) keys.push_back(k);
+	}
+	const auto filled = clock::now();
+	for (size_t i = 0; i < nchurn; i++) {
+		const size_t j = next_random(x) % keys.size();
+		map.erase(keys[j]);
+		key_type k;
+		do {
+			k = next_random(x);
+		} while (!map.emplace(k, k).second);
+		keys[j] = k;
+	}
+	const auto churned = clock::now();
+
+	const std::chrono::duration<double, std::nano> insert = filled - start;
+	const std::chrono::duration<double, std::nano> churn = churned - filled;
+	result r;
+	r.insert_ns = insert.count() / nkeys;
+	r.churn_ns = churn.count() / nchurn;
+	return r;
+}
+
+void print(const std::string & name, const result & r)
+{
+	std::cout << name << "\t" << r.insert_ns << "\t" << r.churn_ns << std::endl;
+}
+
+/**
+ * main function.
+ */
+int main(int argc, char **argv)
+{
+	const size_t nkeys = (argc > 1) ? std::atol(argv[1]) : 100000;
+	const size_t nchurn = (argc > 2) ? std::atol(argv[2]) : 1000000;
+	/* a map node needs less than 64 bytes, but fragmentation costs some memory */
+	const size_t memsize = 4 * 64 * nkeys + (1 << 20);
+	std::vector<uint8_t> mem(memsize);
+
+	std::cout << "allocator\tinsert_ns_per_op\tchurn_ns_per_op" << std::endl;
+	{
+		std::map<key_type, mapped_type> map;
+		print("std::allocator", run(map, nkeys, nchurn));
+	}
+	{
+		bitmap_arena arena(mem.data(), mem.size(), "bitmap");
+		bitmap_allocator alloc(arena);
+		std::map<key_type, mapped_type, std::less<key_type>, bitmap_allocator> map(alloc);
+		print("bitmap_arena", run(map, nkeys, nchurn));
+	}
+	{
+		slab_arena arena(mem.data(), mem.size(), "slab");
+		slab_allocator alloc(arena);
+		std::map<key_type, mapped_type, std::less<key_type>, slab_allocator> map(alloc);
+		print("slab_arena", run(map, nkeys, nchurn));
+	}
+	return 0;
+}
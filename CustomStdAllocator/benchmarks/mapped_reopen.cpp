@@ -0,0 +1,90 @@
+#include "StaticMemoryAllocator/allocator.hpp"
+#include "StaticMemoryAllocator/mapped_arena.hpp"
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <chrono>
+
+/**
+ * Benchmark of the warm-up of a lookup vector: building it
+ * (from random values) versus reopening it from a file managed by a mapped_arena.
+ *
+ * The vector is built in the file once, then the file is unmapped,
+ * mapped again (as after a restart) and the vector is used by its root
+ * without any deserialization (reopen_ms includes a pass over all values,
+ * i.e. faulting in all pages).
+ *
+ * usage: mapped_reopen [elements] [file]
+ */
+
+typedef uint64_t value_type;
+
+typedef StaticMemoryAllocator::mapped_arena<>                          arena_type;
+typedef StaticMemoryAllocator::allocator<value_type, arena_type>       value_allocator;
+typedef std::vector<value_type, value_allocator>                       mapped_vector;
+
+#include "StaticMemoryAllocator/allocator_impl.hpp"
+#include "StaticMemoryAllocator/mapped_arena_impl.hpp"
+template class StaticMemoryAllocator::allocator<value_type, arena_type>;
+template class StaticMemoryAllocator::mapped_arena<>;
+
+static uint64_t next_random(uint64_t & x)
+{
+	x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+	return x;
+}
+
+static double ms_since(const std::chrono::steady_clock::time_point & start)
+{
+	const std::chrono::duration<double, std::milli> d = std::chrono::steady_clock::now() - start;
+	return d.count();
+}
+
+/**
+ * main function.
+ */
+int main(int argc, char **argv)
+{
+	typedef std::chrono::steady_clock clock;
+	const size_t n = (argc > 1) ? std::atol(argv[1]) : 10000000;
+	const std::string path = (argc > 2) ? argv[2] : "mapped_reopen.bin";
+	const size_t memsize = 2 * n * sizeof(value_type) + (1 << 20);
+	std::remove(path.c_str());
+
+	std::cout << "warmup\telements\tms" << std::endl;
+	value_type sum_built = 0;
+	{
+		const auto start = clock::now();
+		StaticMemoryAllocator::mapped_file file(path, memsize);
+		arena_type & arena = arena_type::attach(file.data(), file.size(), "lookup");
+		mapped_vector *const v = new (arena.allocate(sizeof(mapped_vector), alignof(mapped_vector))) mapped_vector(value_allocator(arena));
+		arena.set_root(v);
+		v->reserve(n);
+		uint64_t x = 88172645463325252ull;
+		for (size_t i = 0; i < n; i++) {
+			v->push_back(next_random(x));
+		}
+		for (const value_type value : *v) sum_built += value;
+		std::cout << "build\t" << n << "\t" << ms_since(start) << std::endl;
+	}
+	value_type sum_reopened = 0;
+	{
+		const auto start = clock::now();
+		StaticMemoryAllocator::mapped_file file(path, memsize);
+		arena_type & arena = arena_type::attach(file.data(), file.size());
+		const mapped_vector *const v = static_cast<const mapped_vector *>(arena.root());
+		for (const value_type value : *v) sum_reopened += value;
+		std::cout << "reopen\t" << v->size() << "\t" << ms_since(start) << std::endl;
+	}
+	std::remove(path.c_str());
+	if (sum_built != sum_reopened) {
+		std::cerr << "reopened vector differs from the built one" << std::endl;
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,174 @@
+#include "StaticMemoryAllocator/allocator.hpp"
+#include "StaticMemoryAllocator/slab_arena.hpp"
+#include "StaticMemoryAllocator/object_pool.hpp"
+
+#include <memory>
+#include <iostream>
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstdlib>
+#include <chrono>
+
+/**
+ * Benchmark of creating and destroying objects of a fixed size
+ * using new/delete, the allocator (of the bitmap_arena and the slab_arena)
+ * and the object_pool.
+ *
+ * n objects are alive, for each churn operation a random object is
+ * destroyed and a new one is created. Then all objects are destroyed
+ * and created again in one batch.
+ *
+ * Columns: allocator, churn_ns_per_op, batch_ns_per_object.
+ *
+ * usage: object_churn [objects] [churn operations]
+ */
+
+struct object
+{
+	uint64_t key;
+	uint64_t values[5];
+
+	explicit object(const uint64_t key)
+		: key(key), values{key, key, key, key, key}
+	{
+	}
+};
+
+static const size_t granule = 16;
+
+typedef StaticMemoryAllocator::bitmap_arena<granule>      bitmap_arena;
+typedef StaticMemoryAllocator::slab_arena<bitmap_arena>   slab_arena;
+
+typedef StaticMemoryAllocator::allocator<object, bitmap_arena> bitmap_allocator;
+typedef StaticMemoryAllocator::allocator<object, slab_arena>   slab_allocator;
+typedef StaticMemoryAllocator::object_pool<object>             pool_type;
+
+#include "StaticMemoryAllocator/allocator_impl.hpp"
+#include "StaticMemoryAllocator/slab_arena_impl.hpp"
+#include "StaticMemoryAllocator/object_pool_impl.hpp"
+template class StaticMemoryAllocator::allocator<object, bitmap_arena>;
+template class StaticMemoryAllocator::allocator<object, slab_arena>;
+template class StaticMemoryAllocator::object_pool<object>;
+
+struct result
+{
+	double churn_ns;
+	double batch_ns;
+};
+
+static uint64_t next_random(uint64_t & x)
+{
+	x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+	return x;
+}
+
+/* creates and destroys objects by new/delete */
+struct heap_objects
+{
+	object *create(const uint64_t key) { return new object(key); }
+
+	void destroy(object *const p) { delete p; }
+
+	void create_n(object **const out, const size_t n) { for (size_t i = 0; i < n; i++) out[i] = create(i); }
+
+	void destroy_n(object *const *const ps, const size_t n) { for (size_t i = 0; i < n; i++) destroy(ps[i]); }
+};
+
+/* creates and destroys objects by an allocator */
+template <class Allocator>
+struct allocator_objects
+{
+	Allocator alloc;
+
+	object *create(const uint64_t key)
+	{
+		object *const p = alloc.allocate(1);
+		alloc.construct(p, key);
+		return p;
+	}
+
+	void destroy(object *const p)
+	{
+		alloc.destroy(p);
+		alloc.deallocate(p, 1);
+	}
+
+	void create_n(object **const out, const size_t n) { for (size_t i = 0; i < n; i++) out[i] = create(i); }
+
+	void destroy_n(object *const *const ps, const size_t n) { for (size_t i = 0; i < n; i++) destroy(ps[i]); }
+};
+
+/* creates and destroys objects by an object_pool */
+struct pool_objects
+{
+	pool_type & pool;
+
+	object *create(const uint64_t key) { return pool.create(key); }
+
+	void destroy(object *const p) { pool.destroy(p); }
+
+	void create_n(object **const out, const size_t n) { pool.create_n(out, n, uint64_t(0)); }
+
+	void destroy_n(object *const *const ps, const size_t n) { pool.destroy_n(ps, n); }
+};
+
+template <class Objects>
+result run(Objects objects, const size_t n, const size_t nchurn)
+{
+	typedef std::chrono::steady_clock clock;
+	uint64_t x = 88172645463325252ull;
+	std::vector<object *> live(n);
+	objects.create_n(live.data(), n);
+
+	const auto start = clock::now();
+	for (size_t i = 0; i < nchurn; i++) {
+		const size_t j = next_random(x) % n;
+		objects.destroy(live[j]);
+		live[j] = objects.create(x);
+	}
+	const auto churned = clock::now();
+	objects.destroy_n(live.data(), n);
+	objects.create_n(live.data(), n);
+	const auto batched = clock::now();
+	objects.destroy_n(live.data(), n);
+
+	const std::chrono::duration<double, std::nano> churn = churned - start;
+	const std::chrono::duration<double, std::nano> batch = batched - churned;
+	result r;
+	r.churn_ns = churn.count() / nchurn;
+	r.batch_ns = batch.count() / n;
+	return r;
+}
+
+void print(const std::string & name, const result & r)
+{
+	std::cout << name << "\t" << r.churn_ns << "\t" << r.batch_ns << std::endl;
+}
+
+/**
+ * main function.
+ */
+int main(int argc, char **argv)
+{
+	const size_t n = (argc > 1) ? std::atol(argv[1]) : 100000;
+	const size_t nchurn = (argc > 2) ? std::atol(argv[2]) : 1000000;
+	const size_t memsize = 2 * sizeof(object) * n + (1 << 20);
+	std::vector<uint8_t> mem(memsize);
+
+	std::cout << "allocator\tchurn_ns_per_op\tbatch_ns_per_object" << std::endl;
+	print("new/delete", run(heap_objects(), n, nchurn));
+	{
+		bitmap_arena arena(mem.data(), mem.size(), "bitmap");
+		print("bitmap_arena", run(allocator_objects<bitmap_allocator>{bitmap_allocator(arena)}, n, nchurn));
+	}
+	{
+		slab_arena arena(mem.data(), mem.size(), "slab");
+		print("slab_arena", run(allocator_objects<slab_allocator>{slab_allocator(arena)}, n, nchurn));
+	}
+	{
+		pool_type pool(mem.data(), mem.size(), "pool");
+		print("object_pool", run(pool_objects{pool}, n, nchurn));
+	}
+	return 0;
+}
@@ -0,0 +1,114 @@
+#include "StaticMemoryAllocator/allocator.hpp"
+#include "StaticMemoryAllocator/monotonic_arena.hpp"
+#include "StaticMemoryAllocator/tlsf_arena.hpp"
+
+#include <iostream>
+#include <vector>
+#include <map>
+#include <string>
+#include <cstdint>
+#include <cstdlib>
+#include <chrono>
+#include <functional>
+
+/**
+ * Benchmark of per-request allocations, which all die together
+ * at the end of a request, using std::allocator, the bitmap_arena,
+ * the tlsf_arena and the monotonic_arena (which is reset after each request).
+ *
+ * A request fills a map of random keys and a growing vector.
+ *
+ * Columns: allocator, ns_per_request.
+ *
+ * usage: request_scope [requests] [map entries per request]
+ */
+
+typedef uint64_t key_type;
+
+static const size_t granule = 16;
+
+typedef StaticMemoryAllocator::bitmap_arena<granule> bitmap_arena;
+
+#include "StaticMemoryAllocator/allocator_impl.hpp"
+template class StaticMemoryAllocator::allocator<key_type, bitmap_arena>;
+template class StaticMemoryAllocator::allocator<key_type, StaticMemoryAllocator::tlsf_arena>;
+template class StaticMemoryAllocator::allocator<key_type, StaticMemoryAllocator::monotonic_arena>;
+
+static uint64_t next_random(uint64_t & x)
+{
+	x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+	return x;
+}
+
+template <class Allocator>
+uint64_t serve(const Allocator & alloc, const size_t nentries, uint64_t & x)
+{
+	typedef typename Allocator::template rebind<std::pair<const key_type, key_type>>::other map_allocator;
+	std::map<key_type, key_type, std::less<key_type>, map_allocator> map{map_allocator(alloc)};
+	std::vector<key_type, Allocator> values{alloc};
+	for (size_t i = 0; i < nentries; i++) {
+		const key_type k = next_random(x);
+		map.emplace(k, i);
+		values.push_back(k);
+	}
+	return map.begin()->first + values.back();
+}
+
+template <class Serve>
+double run(const size_t nrequests, Serve serve_request)
+{
+	typedef std::chrono::steady_clock clock;
+	uint64_t x = 88172645463325252ull;
+	uint64_t sum = 0;
+	const auto start = clock::now();
+	for (size_t r = 0; r < nrequests; r++) {
+		sum += serve_request(x);
+	}
+	const std::chrono::duration<double, std::nano> d = clock::now() - start;
+	/* keeps the requests from being optimized away */
+	if (sum == 42) std::cerr << sum << std::endl;
+	return d.count() / nrequests;
+}
+
+void print(const std::string & name, const double ns)
+{
+	std::cout << name << "\t" << ns << std::endl;
+}
+
+/**
+ * main function.
+ */
+int main(int argc, char **argv)
+{
+	const size_t nrequests = (argc > 1) ? std::atol(argv[1]) : 10000;
+	const size_t nentries = (argc > 2) ? std::atol(argv[2]) : 1000;
+	/* map nodes and all capacities of the vector (which are never freed by the monotonic_arena) */
+	const size_t memsize = 4 * 64 * nentries + 4 * sizeof(key_type) * nentries + (1 << 16);
+	std::vector<uint8_t> mem(memsize);
+
+	std::cout << "allocator\tns_per_request" << std::endl;
+	{
+		const std::allocator<key_type> alloc;
+		print("std::allocator", run(nrequests, [&](uint64_t & x) { return serve(alloc, nentries, x); }));
+	}
+	{
+		bitmap_arena arena(mem.data(), mem.size(), "bitmap");
+		const StaticMemoryAllocator::allocator<key_type, bitmap_arena> alloc(arena);
+		print("bitmap_arena", run(nrequests, [&](uint64_t & x) { return serve(alloc, nentries, x); }));
+	}
+	{
+		StaticMemoryAllocator::tlsf_arena arena(mem.data(), mem.size(), "tlsf");
+		const StaticMemoryAllocator::allocator<key_type, StaticMemoryAllocator::tlsf_arena> alloc(arena);
+		print("tlsf_arena", run(nrequests, [&](uint64_t & x) { return serve(alloc, nentries, x); }));
+	}
+	{
+		StaticMemoryAllocator::monotonic_arena arena(mem.data(), mem.size(), "monotonic");
+		const StaticMemoryAllocator::allocator<key_type, StaticMemoryAllocator::monotonic_arena> alloc(arena);
+		print("monotonic_arena", run(nrequests, [&](uint64_t & x) {
+			const uint64_t result = serve(alloc, nentries, x);
+			arena.reset();
+			return result;
+		}));
+	}
+	return 0;
+}
@@ -0,0 +1,164 @@
+#include "StaticMemoryAllocator/allocator.hpp"
+#include "StaticMemoryAllocator/sharded_arena.hpp"
+
+#include <memory>
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <iostream>
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <thread>
+#include <chrono>
+
+/**
+ * Scaling benchmark of 1 to N threads allocating from one concurrent_arena
+ * (i.e., one bitmap) against a sharded_arena of concurrent_arenas.
+ *
+ * Each thread keeps a window of live blocks of random sizes,
+ * each operation frees the oldest block of the window and allocates a new one.
+ * Every remote_stride-th block is handed over to the next thread,
+ * which frees it (the sharded_arena routes it back to its shard by its address).
+ *
+ * Columns: threads, single_mops, sharded_mops (million operations per second).
+ *
+ * usage: sharded_scaling [max threads] [operations per thread] [shards]
+ */
+
+static const size_t granule = 16;
+
+typedef StaticMemoryAllocator::concurrent_arena<granule>  single_arena;
+typedef StaticMemoryAllocator::sharded_arena<single_arena> sharded_arena;
+
+typedef StaticMemoryAllocator::allocator<char, single_arena>  single_allocator;
+typedef StaticMemoryAllocator::allocator<char, sharded_arena> sharded_allocator;
+
+#include "StaticMemoryAllocator/allocator_impl.hpp"
+#include "StaticMemoryAllocator/sharded_arena_impl.hpp"
+template class StaticMemoryAllocator::allocator<char, single_arena>;
+template class StaticMemoryAllocator::allocator<char, sharded_arena>;
+
+static const size_t window = 32;
+static const size_t max_block_size = 256;
+static const size_t remote_stride = 16;
+
+/* number of shards (0: one per core) */
+static size_t shards = 0;
+
+class single_heap
+{
+public:
+	single_heap(void *const memstart, const size_t memsize)
+		: arena(memstart, memsize, "single"),
+		  alloc(arena)
+	{}
+
+	char *allocate(const size_t n) { return alloc.allocate(n); }
+
+	void deallocate(char *const p, const size_t n) { alloc.deallocate(p, n); }
+
+private:
+	single_arena arena;
+	single_allocator alloc;
+};
+
+class sharded_heap
+{
+public:
+	sharded_heap(void *const memstart, const size_t memsize)
+		: arena(memstart, memsize, "sharded", shards),
+		  alloc(arena)
+	{}
+
+	char *allocate(const size_t n) { return alloc.allocate(n); }
+
+	void deallocate(char *const p, const size_t n) { alloc.deallocate(p, n); }
+
+private:
+	sharded_arena arena;
+	sharded_allocator alloc;
+};
+
+typedef std::pair<char *, size_t> block;
+
+/* the size of a block is stored in its first bytes, thus another thread can free it */
+static const size_t min_block_size = sizeof(size_t);
+
+template <class Heap>
+void worker(Heap & heap, std::vector<std::atomic<char *>> & exchange, const unsigned t, const size_t ops)
+{
+	std::vector<block> live(window, block(nullptr, 0));
+	std::atomic<char *> & next = exchange[(t + 1) % exchange.size()];
+	uint32_t x = (t + 1) * 2654435761u + 1;
+	for (size_t i = 0; i < ops; i++) {
+		block & slot = live[i % window];
+		if (slot.first != nullptr) {
+			/* hand the block over to the next thread and free the one handed over before */
+			char *const p = (i % remote_stride == 0) ? next.exchange(slot.first) : slot.first;
+			if (p != nullptr) {
+				size_t n;
+				std::memcpy(&n, p, sizeof(n));
+				heap.deallocate(p, n);
+			}
+		}
+		x ^= x << 13; x ^= x >> 17; x ^= x << 5;
+		slot.second = min_block_size + x % (max_block_size - min_block_size + 1);
+		slot.first = heap.allocate(slot.second);
+		std::memcpy(slot.first, &slot.second, sizeof(slot.second));
+	}
+	for (auto & slot : live) {
+		if (slot.first != nullptr) heap.deallocate(slot.first, slot.second);
+	}
+}
+
+/* returns the throughput in million operations per second */
+template <class Heap>
+double run(const unsigned nthreads, const size_t ops)
+{
+	/* twice the memory of all live (and handed over) blocks, for each shard as well */
+	const size_t nshards = (shards > 0) ? shards : std::max(1u, std::thread::hardware_concurrency());
+	const size_t memsize = 2 * std::max<size_t>(nthreads, nshards) * (window + 1) * (max_block_size + granule);
+	std::vector<uint8_t> mem(memsize);
+	Heap heap(mem.data(), mem.size());
+	std::vector<std::atomic<char *>> exchange(nthreads);
+	for (auto & e : exchange) e.store(nullptr);
+	std::vector<std::thread> threads;
+	const auto start = std::chrono::steady_clock::now();
+	for (unsigned t = 0; t < nthreads; t++) {
+		threads.emplace_back(worker<Heap>, std::ref(heap), std::ref(exchange), t, ops);
+	}
+	for (auto & thread : threads) thread.join();
+	const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+	for (auto & e : exchange) {
+		char *const p = e.load();
+		if (p == nullptr) continue;
+		size_t n;
+		std::memcpy(&n, p, sizeof(n));
+		heap.deallocate(p, n);
+	}
+	/* each operation is one allocate and one deallocate */
+	return (nthreads * ops) / elapsed.count() / 1e6;
+}
+
+/**
+ * main function.
+ */
+int main(int argc, char **argv)
+{
+	const unsigned max_threads = (argc > 1) ? std::atoi(argv[1]) : 64;
+	const size_t ops = (argc > 2) ? std::atol(argv[2]) : 200000;
+	shards = (argc > 3) ? std::atol(argv[3]) : 0;
+
+	std::cout << "threads\tsingle_mops\tsharded_mops" << std::endl;
+	for (unsigned nthreads = 1; ; nthreads = std::min(2 * nthreads, max_threads)) {
+		const double single = run<single_heap>(nthreads, ops);
+		const double sharded = run<sharded_heap>(nthreads, ops);
+		std::cout << nthreads << "\t" << single << "\t" << sharded << std::endl;
+		if (nthreads >= max_threads) break;
+	}
+	return 0;
+}
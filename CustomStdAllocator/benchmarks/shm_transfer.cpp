@@ -0,0 +1,248 @@
+#include "StaticMemoryAllocator/allocator.hpp"
+#include "StaticMemoryAllocator/mapped_arena.hpp"
+
+#include <iostream>
+#include <vector>
+#include <type_traits>
+#include <utility>
+#include <string>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <chrono>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+/**
+ * Benchmark of the transfer of messages (vectors of 64-bit values)
+ * from a producer process to a consumer process:
+ * through a pipe (the values are copied into and out of the kernel)
+ * versus in a shared_arena (the producer fills a vector in shared memory
+ * and sends its offset, the consumer reads and frees it).
+ *
+ * At most window messages are in flight, both processes touch all values.
+ * The consumer maps the shared memory itself (i.e., at another address).
+ * The values of a message in the shared_arena are default-initialised and
+ * not destroyed (see message_allocator), thus as in the pipe transfer,
+ * the producer writes each value once and the consumer reads it once.
+ *
+ * Columns: transfer, message_bytes, mb_per_s.
+ *
+ * usage: shm_transfer [megabytes per message size]
+ */
+
+typedef uint64_t value_type;
+
+typedef StaticMemoryAllocator::shared_arena<>                      arena_type;
+
+/**
+ * Allocator of the messages: a vector resized by it default-initialises
+ * its values (i.e., leaves them uninitialised, the producer fills them),
+ * and trivially destructible values are not destroyed one by one.
+ */
+template <class T>
+class message_allocator : public StaticMemoryAllocator::allocator<T, arena_type>
+{
+public:
+	typedef StaticMemoryAllocator::allocator<T, arena_type> base_type;
+
+	template <class _T1>
+	struct rebind
+	{
+		typedef message_allocator<_T1> other;
+	};
+
+	explicit message_allocator(arena_type & a) throw() : base_type(a) {}
+
+	template <class T2>
+	message_allocator(const message_allocator<T2> & a) throw() : base_type(a) {}
+
+	template <class U>
+	void construct(U *p) { ::new ((void *)p) U; }
+
+	template <class U, class... Args>
+	void construct(U *p, Args&&... args) { ::new ((void *)p) U(std::forward<Args>(args)...); }
+
+	template <class U>
+	typename std::enable_if<std::is_trivially_destructible<U>::value>::type destroy(U *) {}
+
+	template <class U>
+	typename std::enable_if<!std::is_trivially_destructible<U>::value>::type destroy(U *p) { p->~U(); }
+};
+
+typedef message_allocator<value_type>                              value_allocator;
+typedef std::vector<value_type, value_allocator>                   message_type;
+
+#include "StaticMemoryAllocator/allocator_impl.hpp"
+#include "StaticMemoryAllocator/mapped_arena_impl.hpp"
+template class StaticMemoryAllocator::allocator<value_type, arena_type>;
+template class StaticMemoryAllocator::mapped_arena<16, StaticMemoryAllocator::process_mutex>;
+
+static const size_t window = 4;
+static const uint64_t end_of_messages = ~static_cast<uint64_t>(0);
+static const std::string shm_name = "/sma_shm_transfer";
+
+static void write_all(const int fd, const void *const buf, const size_t n)
+{
+	const char *p = static_cast<const char *>(buf);
+	for (size_t done = 0; done < n; ) {
+		const ssize_t w = ::write(fd, p + done, n - done);
+		if (w <= 0) std::abort();
+		done += static_cast<size_t>(w);
+	}
+}
+
+static void read_all(const int fd, void *const buf, const size_t n)
+{
+	char *p = static_cast<char *>(buf);
+	for (size_t done = 0; done < n; ) {
+		const ssize_t r = ::read(fd, p + done, n - done);
+		if (r <= 0) std::abort();
+		done += static_cast<size_t>(r);
+	}
+}
+
+static value_type fill(value_type *const values, const size_t n, const size_t message)
+{
+	value_type sum = 0;
+	for (size_t i = 0; i < n; i++) {
+		values[i] = message + i;
+		sum += values[i];
+	}
+	return sum;
+}
+
+static value_type sum_of(const value_type *const values, const size_t n)
+{
+	value_type sum = 0;
+	for (size_t i = 0; i < n; i++) sum += values[i];
+	return sum;
+}
+
+static void consume_pipe(const int in, const int out, const size_t n)
+{
+	std::vector<value_type> values(n);
+	value_type sum = 0;
+	for (;;) {
+		uint64_t header;
+		read_all(in, &header, sizeof(header));
+		if (header == end_of_messages) break;
+		read_all(in, values.data(), n * sizeof(value_type));
+		sum += sum_of(values.data(), n);
+	}
+	write_all(out, &sum, sizeof(sum));
+}
+
+static void consume_shm(const int in, const int out)
+{
+	StaticMemoryAllocator::shared_memory shm(shm_name, 0);
+	arena_type & arena = arena_type::attach(shm.data(), shm.size());
+	uint8_t *const base = static_cast<uint8_t *>(arena.memstart());
+	value_type sum = 0;
+	for (;;) {
+		uint64_t offset;
+		read_all(in, &offset, sizeof(offset));
+		if (offset == end_of_messages) break;
+		message_type *const message = reinterpret_cast<message_type *>(base + offset);
+		sum += sum_of(message->data(), message->size());
+		message->~message_type();
+		arena.deallocate(message, sizeof(message_type));
+		const char ack = 0;
+		write_all(out, &ack, 1);
+	}
+	write_all(out, &sum, sizeof(sum));
+}
+
+static double run_pipe(const size_t message_bytes, const size_t nmessages)
+{
+	typedef std::chrono::steady_clock clock;
+	const size_t n = message_bytes / sizeof(value_type);
+	int to_consumer[2], to_producer[2];
+	if (::pipe(to_consumer) != 0 || ::pipe(to_producer) != 0) std::abort();
+	const pid_t pid = ::fork();
+	if (pid == 0) {
+		consume_pipe(to_consumer[0], to_producer[1], n);
+		::_exit(0);
+	}
+	std::vector<value_type> values(n);
+	value_type sum = 0;
+	const auto start = clock::now();
+	for (size_t m = 0; m < nmessages; m++) {
+		sum += fill(values.data(), n, m);
+		const uint64_t header = m;
+		write_all(to_consumer[1], &header, sizeof(header));
+		write_all(to_consumer[1], values.data(), n * sizeof(value_type));
+	}
+	write_all(to_consumer[1], &end_of_messages, sizeof(end_of_messages));
+	value_type consumed;
+	read_all(to_producer[0], &consumed, sizeof(consumed));
+	const std::chrono::duration<double> d = clock::now() - start;
+	::waitpid(pid, nullptr, 0);
+	for (const int fd : {to_consumer[0], to_consumer[1], to_producer[0], to_producer[1]}) ::close(fd);
+	if (consumed != sum) std::cerr << "pipe: consumer got a different sum" << std::endl;
+	return message_bytes * nmessages / d.count() / (1 << 20);
+}
+
+static double run_shm(const size_t message_bytes, const size_t nmessages)
+{
+	typedef std::chrono::steady_clock clock;
+	const size_t n = message_bytes / sizeof(value_type);
+	StaticMemoryAllocator::shared_memory::remove(shm_name);
+	StaticMemoryAllocator::shared_memory shm(shm_name, 2 * window * message_bytes + (1 << 20));
+	arena_type & arena = arena_type::attach(shm.data(), shm.size(), "transfer");
+	uint8_t *const base = static_cast<uint8_t *>(arena.memstart());
+	int to_consumer[2], to_producer[2];
+	if (::pipe(to_consumer) != 0 || ::pipe(to_producer) != 0) std::abort();
+	const pid_t pid = ::fork();
+	if (pid == 0) {
+		consume_shm(to_consumer[0], to_producer[1]);
+		::_exit(0);
+	}
+	value_type sum = 0;
+	size_t inflight = 0;
+	const auto start = clock::now();
+	for (size_t m = 0; m < nmessages; m++) {
+		if (inflight == window) {
+			char ack;
+			read_all(to_producer[0], &ack, 1);
+			inflight--;
+		}
+		message_type *const message = new (arena.allocate(sizeof(message_type), alignof(message_type)))
+			message_type(value_allocator(arena));
+		message->resize(n);
+		sum += fill(message->data(), n, m);
+		const uint64_t offset = reinterpret_cast<uint8_t *>(message) - base;
+		write_all(to_consumer[1], &offset, sizeof(offset));
+		inflight++;
+	}
+	write_all(to_consumer[1], &end_of_messages, sizeof(end_of_messages));
+	for (; inflight > 0; inflight--) {
+		char ack;
+		read_all(to_producer[0], &ack, 1);
+	}
+	value_type consumed;
+	read_all(to_producer[0], &consumed, sizeof(consumed));
+	const std::chrono::duration<double> d = clock::now() - start;
+	::waitpid(pid, nullptr, 0);
+	for (const int fd : {to_consumer[0], to_consumer[1], to_producer[0], to_producer[1]}) ::close(fd);
+	StaticMemoryAllocator::shared_memory::remove(shm_name);
+	if (consumed != sum) std::cerr << "shared_arena: consumer got a different sum" << std::endl;
+	return message_bytes * nmessages / d.count() / (1 << 20);
+}
+
+/**
+ * main function.
+ */
+int main(int argc, char **argv)
+{
+	const size_t megabytes = (argc > 1) ? std::atol(argv[1]) : 1024;
+
+	std::cout << "transfer\tmessage_bytes\tmb_per_s" << std::endl;
+	for (size_t message_bytes = 4096; message_bytes <= (1 << 20); message_bytes *= 16) {
+		const size_t nmessages = (megabytes << 20) / message_bytes;
+		std::cout << "pipe\t" << message_bytes << "\t" << run_pipe(message_bytes, nmessages) << std::endl;
+		std::cout << "shared_arena\t" << message_bytes << "\t" << run_shm(message_bytes, nmessages) << std::endl;
+	}
+	return 0;
+}
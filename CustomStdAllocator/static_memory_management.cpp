@@ -9,6 +9,8 @@
 #include <new>
 #include <thread>
 
+typedef StaticMemoryAllocator::bitmap_arena<> MyStaticMemoryArena;
+
 template <typename T>
 using MyStaticMemoryAllocator = StaticMemoryAllocator::allocator<T>;
 
@@ -75,9 +77,11 @@ int test_memory_management(void *const start1, void *const start2, const size_t
 	 * sharing the same memory block, starting at \p start1 and of size \p size.
 	 */
 	std::cout << "--> " << "construct allocators.." << std::endl;
-	MyStaticMemoryAllocator<stype> sma_s1(start1, memsize, "mem1");
+	MyStaticMemoryArena arena1(start1, memsize, "mem1");
+	MyStaticMemoryArena arena2(start2, memsize, "mem2");
+	MyStaticMemoryAllocator<stype> sma_s1(arena1);
 	MyStaticMemoryAllocator<ttype> sma_t1(sma_s1);
-	MyStaticMemoryAllocator<ttype> sma_t2(start2, memsize, "mem2");
+	MyStaticMemoryAllocator<ttype> sma_t2(arena2);
 	wait();
 
 	/*
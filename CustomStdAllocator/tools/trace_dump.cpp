@@ -0,0 +1,119 @@
+#include "StaticMemoryAllocator/trace.hpp"
+
+#include <iostream>
+#include <iomanip>
+#include <map>
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstdio>
+
+/**
+ * Prints a trace file written by trace_ring::dump() as text:
+ * one event per line, the times relative to the first event.
+ * At the end, the number of events and bytes per operation
+ * and the peak of the bytes in use (per arena) are printed.
+ *
+ * Columns: sequence, time_ns, op, arena, offset, size.
+ *
+ * usage: trace_dump <trace file>
+ */
+
+using StaticMemoryAllocator::trace_event;
+using StaticMemoryAllocator::trace_op;
+using StaticMemoryAllocator::trace_ring;
+
+static
+bool read_events(const std::string & path, std::vector<trace_event> & events)
+{
+	std::FILE *const f = std::fopen(path.c_str(), "rb");
+	if (f == nullptr) return false;
+	uint64_t header[2];
+	bool ok = std::fread(header, sizeof(header), 1, f) == 1 && header[0] == trace_ring::file_magic;
+	/* the number of events must fit into the rest of the file */
+	long filesize = -1;
+	if (ok && std::fseek(f, 0, SEEK_END) == 0) filesize = std::ftell(f);
+	ok = ok && filesize >= static_cast<long>(sizeof(header))
+		&& header[1] <= (static_cast<uint64_t>(filesize) - sizeof(header)) / sizeof(trace_event)
+		&& std::fseek(f, sizeof(header), SEEK_SET) == 0;
+	if (ok) {
+		events.resize(header[1]);
+		ok = events.empty() || std::fread(events.data(), sizeof(trace_event), events.size(), f) == events.size();
+	}
+	std::fclose(f);
+	return ok;
+}
+
+/**
+ * main function.
+ */
+int main(int argc, char **argv)
+{
+	if (argc < 2) {
+		std::cerr << "usage: " << argv[0] << " <trace file>" << std::endl;
+		return 2;
+	}
+	std::vector<trace_event> events;
+	if (!read_events(argv[1], events)) {
+		std::cerr << "cannot read trace file " << argv[1] << std::endl;
+		return 1;
+	}
+
+	struct op_stats
+	{
+		uint64_t count;
+		uint64_t bytes;
+	};
+	std::map<std::string, op_stats> ops;
+	/* bytes in use and their peak per arena */
+	std::map<uint64_t, std::pair<int64_t, int64_t>> used;
+	/* sizes of the live blocks per arena and offset (to account expand and shrink) */
+	std::map<std::pair<uint64_t, uint64_t>, uint64_t> blocks;
+
+	std::cout << "sequence\ttime_ns\top\tarena\toffset\tsize" << std::endl;
+	const uint64_t t0 = events.empty() ? 0 : events.front().timestamp;
+	for (const trace_event & e : events) {
+		const trace_op op = static_cast<trace_op>(e.op);
+		const char *const name = StaticMemoryAllocator::trace_op_name(op);
+		std::cout << e.sequence << "\t" << (e.timestamp - t0) << "\t" << name << "\t"
+			  << "0x" << std::hex << e.arena << std::dec << "\t" << e.offset << "\t" << e.size << std::endl;
+		op_stats & s = ops[name];
+		s.count++;
+		s.bytes += e.size;
+
+		const std::pair<uint64_t, uint64_t> key(e.arena, e.offset);
+		int64_t delta = 0;
+		switch (op) {
+		case trace_op::allocate:
+			blocks[key] = e.size;
+			delta = static_cast<int64_t>(e.size);
+			break;
+		case trace_op::deallocate:
+			delta = -static_cast<int64_t>(blocks.count(key) ? blocks[key] : e.size);
+			blocks.erase(key);
+			break;
+		case trace_op::expand:
+		case trace_op::shrink:
+			/* the size before is unknown, if the block was allocated before the first event */
+			delta = blocks.count(key) ? static_cast<int64_t>(e.size) - static_cast<int64_t>(blocks[key]) : 0;
+			blocks[key] = e.size;
+			break;
+		default:
+			break;
+		}
+		std::pair<int64_t, int64_t> & u = used[e.arena];
+		u.first += delta;
+		if (u.first > u.second) u.second = u.first;
+	}
+
+	std::cerr << "events: " << events.size() << std::endl;
+	for (const auto & o : ops) {
+		std::cerr << "  " << std::setw(16) << std::left << o.first
+			  << o.second.count << " events, " << o.second.bytes << " bytes" << std::endl;
+	}
+	for (const auto & u : used) {
+		std::cerr << "arena 0x" << std::hex << u.first << std::dec << ": "
+			  << u.second.first << " bytes in use at the end, peak " << u.second.second << " bytes" << std::endl;
+	}
+	return 0;
+}